@@ -1,4 +1,6 @@
 #include <iostream>
+#include <cmath>
+#include <deque>
 #include <Eigen/Dense>
 
 using namespace Eigen;
@@ -22,6 +24,165 @@ rse of A^T A and provides a numerically stable solution
 problem iteratively. 
 */ 
 
+/*
+Online recursive least squares (RLS) for live data.
+
+Refactoring A^T A with LLT after every new observation costs
+O(p^3) per row. Instead the Cholesky factor L of the augmented
+matrix
+
+    [A b]^T W [A b] = L L^T,   L = [ L11   0  ]
+                                   [ l21^T lambda ]
+
+is kept up to date. A new row w = [a^T b] changes it by w w^T,
+which a rank-1 update absorbs with p + 1 Givens rotations in
+O(p^2). A row leaving a sliding window is removed by a rank-1
+downdate (hyperbolic rotations), also O(p^2). The augmented
+factor gives everything at any moment:
+
+- coefficients: solve L11^T x = l21 (one triangular solve, O(p^2)),
+- residual sum of squares: lambda^2, so MSE = lambda^2 / count.
+
+With exponential forgetting (0 < forgetting < 1) the weights W
+decay by the forgetting factor per observation (L is scaled by
+its square root before each update), so old data fade out
+smoothly. Forgetting and a window can be combined; the row
+leaving the window is then downdated with its decayed weight.
+
+Eigen's LLT::rankUpdate cannot start from an empty (all-zero)
+factor, so the rotations are written out here. If rounding makes
+a downdate fail, the factor is rebuilt from the rows in the
+window.
+*/
+
+class RecursiveLeastSquares {
+public:
+    // windowSize = 0 keeps every observation; forgetting = 1 weighs all equally
+    explicit RecursiveLeastSquares(int numFeatures, std::size_t windowSize = 0, double forgetting = 1.0)
+        : numFeatures_(numFeatures), windowSize_(windowSize), forgetting_(forgetting),
+          factor_(MatrixXd::Zero(numFeatures + 1, numFeatures + 1)) {}
+
+    // Function to add one observation a^T x = b in O(p^2)
+    void addObservation(const VectorXd& a, double b) {
+        VectorXd w(numFeatures_ + 1);
+        w << a, b;
+
+        if (forgetting_ != 1.0) {
+            factor_ *= std::sqrt(forgetting_);
+            weightSum_ *= forgetting_;
+        }
+        update(w);
+        weightSum_ += 1.0;
+
+        if (windowSize_ > 0) {
+            window_.push_back(w);
+            if (window_.size() > windowSize_) {
+                // The leaving row has been scaled by forgetting^windowSize since it arrived
+                double weight = std::pow(forgetting_, static_cast<double>(windowSize_));
+                if (!downdate(window_.front() * std::sqrt(weight))) {
+                    window_.pop_front();
+                    refactor();
+                    return;
+                }
+                weightSum_ -= weight;
+                window_.pop_front();
+            }
+        }
+    }
+
+    // Function to compute the current coefficients; false while they are undetermined
+    bool coefficients(VectorXd& x) const {
+        auto L11 = factor_.topLeftCorner(numFeatures_, numFeatures_);
+        double largest = L11.diagonal().cwiseAbs().maxCoeff();
+        if (!(largest > 0.0) || L11.diagonal().cwiseAbs().minCoeff() <= 1e-12 * largest) {
+            return false;
+        }
+        x = L11.transpose().triangularView<Upper>().solve(
+                factor_.row(numFeatures_).head(numFeatures_).transpose());
+        return true;
+    }
+
+    // Function to return the (weighted) mean squared error of the current fit
+    double meanSquaredError() const {
+        double rss = factor_(numFeatures_, numFeatures_) * factor_(numFeatures_, numFeatures_);
+        return weightSum_ > 0.0 ? rss / weightSum_ : 0.0;
+    }
+
+    // Number of observations in the window (all of them without a window)
+    double effectiveCount() const { return weightSum_; }
+
+private:
+    // Function to apply L L^T + w w^T with Givens rotations
+    void update(VectorXd w) {
+        const int n = numFeatures_ + 1;
+        for (int k = 0; k < n; ++k) {
+            double r = std::hypot(factor_(k, k), w(k));
+            if (r == 0.0) {
+                continue;
+            }
+            double c = factor_(k, k) / r;
+            double s = w(k) / r;
+            factor_(k, k) = r;
+            for (int i = k + 1; i < n; ++i) {
+                double lik = factor_(i, k);
+                factor_(i, k) = c * lik + s * w(i);
+                w(i) = -s * lik + c * w(i);
+            }
+        }
+    }
+
+    // Function to apply L L^T - w w^T with hyperbolic rotations; false if the
+    // result would not be positive semidefinite
+    bool downdate(VectorXd w) {
+        const int n = numFeatures_ + 1;
+        MatrixXd saved = factor_;
+        for (int k = 0; k < n; ++k) {
+            double lkk = factor_(k, k);
+            double difference = (lkk - w(k)) * (lkk + w(k));
+            if (difference < 0.0 || (lkk == 0.0 && w(k) != 0.0)) {
+                factor_ = saved;
+                return false;
+            }
+            if (lkk == 0.0) {
+                continue;
+            }
+            double r = std::sqrt(difference);
+            if (r <= 1e-12 * lkk) {
+                // Exact cancellation would divide by zero below; rebuild instead
+                factor_ = saved;
+                return false;
+            }
+            double c = r / lkk;
+            double s = w(k) / lkk;
+            factor_(k, k) = r;
+            for (int i = k + 1; i < n; ++i) {
+                factor_(i, k) = (factor_(i, k) - s * w(i)) / c;
+                w(i) = c * w(i) - s * factor_(i, k);
+            }
+        }
+        return true;
+    }
+
+    // Function to rebuild the factor from the rows in the window, O(window * p^2)
+    void refactor() {
+        factor_.setZero();
+        weightSum_ = 0.0;
+        double weight = std::pow(forgetting_, static_cast<double>(window_.size() - 1));
+        for (const auto& w : window_) {
+            update(w * std::sqrt(weight));
+            weightSum_ += weight;
+            weight /= forgetting_;
+        }
+    }
+
+    int numFeatures_;
+    std::size_t windowSize_;
+    double forgetting_;
+    MatrixXd factor_;          // Lower-triangular factor of the augmented matrix
+    std::deque<VectorXd> window_;
+    double weightSum_ = 0.0;   // Sum of the observation weights
+};
+
 int main() {
     // Define the observed data points
     VectorXd b(10);
@@ -64,5 +225,36 @@ int main() {
     std::cout << x << std::endl;
     std::cout << "Mean Squared Error (MSE): " << mse << std::endl;
 
+    // The same fit, observation by observation
+    RecursiveLeastSquares rls(2);
+    for (int i = 0; i < A.rows(); ++i) {
+        rls.addObservation(A.row(i).transpose(), b(i));
+    }
+    VectorXd xOnline;
+    if (rls.coefficients(xOnline)) {
+        std::cout << "Online fit differs by " << (xOnline - x).norm() << ", MSE " << rls.meanSquaredError()
+                  << std::endl;
+    }
+
+    // A drifting line tracked over a sliding window of 50 observations
+    const int windowSize = 50;
+    RecursiveLeastSquares tracker(2, windowSize);
+    MatrixXd rows(1000, 2);
+    VectorXd values(1000);
+    for (int t = 0; t < 1000; ++t) {
+        double u = std::sin(0.37 * t) * 5.0;
+        rows.row(t) << 1.0, u;
+        values(t) = 0.002 * t + (1.0 + 0.001 * t) * u + 0.01 * std::cos(1.3 * t);
+        tracker.addObservation(rows.row(t).transpose(), values(t));
+    }
+    MatrixXd recentRows = rows.bottomRows(windowSize);
+    VectorXd recentValues = values.tail(windowSize);
+    VectorXd xWindow = (recentRows.transpose() * recentRows).llt().solve(recentRows.transpose() * recentValues);
+    VectorXd xTracked;
+    if (tracker.coefficients(xTracked)) {
+        std::cout << "Sliding window fit:\n" << xTracked << "\ndiffers from refitting the window by "
+                  << (xTracked - xWindow).norm() << ", MSE " << tracker.meanSquaredError() << std::endl;
+    }
+
     return 0;
 } 
\ No newline at end of file
@@ -3,7 +3,19 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <iomanip>
 #include <Eigen/Dense> 
+#include <unsupported/Eigen/FFT>
+
+#include "SignalIO.h"
+#include "SIMDDispatch.h"
+#include "StreamingFilters.h"
 
 using namespace Eigen;
 
@@ -36,79 +48,972 @@ ing filtered data can be further analyzed or visualized
 // Function to read data from a CSV file
 std::vector<double> readCSV(const std::string& filename) {
     std::vector<double> data;
-
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << filename << std::endl;
+    std::vector<SignalParseError> errors;
+    if (!readSignalFile(filename, data, errors)) {
         return data;
     }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string cell;
-        while (std::getline(ss, cell, ',')) {
-            data.push_back(std::stod(cell));
-        }
+    if (!errors.empty()) {
+        reportSignalParseErrors(filename, errors);
+        return std::vector<double>();
     }
-
-    file.close();
     return data;
 }
 
 // Function to write data to a CSV file
 void writeCSV(const std::string& filename, const std::vector<double>& data) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open the file: " << filename << std::endl;
-        return;
+    writeSignalFile(filename, data);
+}
+
+// Convolution strategies available to the FIR filter
+enum class FIRMode {
+    Automatic,      // Let the library pick Direct or FFT based on the tap count
+    Direct,         // Time-domain multiply-accumulate
+    FFT,            // Overlap-save convolution in the frequency domain
+    MovingAverage   // Running sum, valid only for uniform (boxcar) taps; never picked automatically
+};
+
+// Filters with at least this many taps are convolved via FFT in automatic mode
+const int kFFTTapThreshold = 64;
+
+// Frequency responses supported by the windowed-sinc designer
+enum class FilterType { LowPass, HighPass, BandPass };
+
+// Windows applied to the ideal (sinc) impulse response
+enum class WindowType { Rectangular, Hamming, Blackman, Kaiser };
+
+// Parameters of a windowed-sinc design. lowCutoff is the cutoff of low-pass
+// and high-pass designs; band-pass designs pass [lowCutoff, highCutoff].
+// kaiserBeta is only used by the Kaiser window.
+struct FIRDesignSpec {
+    FilterType type = FilterType::LowPass;
+    double lowCutoff = 0.0;
+    double highCutoff = 0.0;
+    double samplingRate = 1.0;
+    int filterOrder = 0;
+    WindowType window = WindowType::Hamming;
+    double kaiserBeta = 0.0;
+
+    bool operator<(const FIRDesignSpec& other) const {
+        return std::tie(type, lowCutoff, highCutoff, samplingRate, filterOrder, window, kaiserBeta) <
+               std::tie(other.type, other.lowCutoff, other.highCutoff, other.samplingRate, other.filterOrder,
+                        other.window, other.kaiserBeta);
+    }
+};
+
+// Function to evaluate the zeroth-order modified Bessel function of the first kind
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < 1e-17 * sum) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Function to evaluate window sample n of a window spanning filterOrder + 1 taps
+double evaluateWindow(WindowType window, int n, int filterOrder, double kaiserBeta) {
+    double phase = 2.0 * M_PI * n / filterOrder;
+    switch (window) {
+    case WindowType::Hamming:
+        return 0.54 - 0.46 * std::cos(phase);
+    case WindowType::Blackman:
+        return 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+    case WindowType::Kaiser: {
+        double r = 2.0 * n / filterOrder - 1.0;
+        return besselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(kaiserBeta);
     }
+    default:
+        return 1.0;
+    }
+}
 
-    for (const auto& value : data) {
-        file << value << std::endl;
+// Function to compute a windowed-sinc low-pass prototype with unity DC gain
+std::vector<double> designWindowedSincLowPass(double cutoff, const FIRDesignSpec& spec) {
+    int filterOrder = spec.filterOrder;
+    double normalizedCutoff = cutoff / spec.samplingRate;
+    std::vector<double> coefficients(filterOrder + 1);
+
+    double sum = 0.0;
+    for (int n = 0; n <= filterOrder; ++n) {
+        double t = n - filterOrder / 2.0;
+        double ideal = (t == 0.0) ? 2.0 * normalizedCutoff
+                                  : std::sin(2.0 * M_PI * normalizedCutoff * t) / (M_PI * t);
+        coefficients[n] = ideal * evaluateWindow(spec.window, n, filterOrder, spec.kaiserBeta);
+        sum += coefficients[n];
+    }
+    for (auto& value : coefficients) {
+        value /= sum;
     }
 
-    file.close();
+    return coefficients;
 }
 
-// Function to apply an FIR low-pass filter
-std::vector<double> applyFIRLowPassFilter(const std::vector<double>& data, double cutoffFrequency, double samplingRate) {
+// Function to design a windowed-sinc FIR filter. High-pass designs need an
+// even filter order so the response can be zero at DC.
+std::vector<double> designWindowedSincFIR(const FIRDesignSpec& spec) {
+    double nyquist = spec.samplingRate / 2.0;
+    if (spec.filterOrder < 1 || spec.samplingRate <= 0.0 || spec.lowCutoff <= 0.0 || spec.lowCutoff >= nyquist) {
+        std::cerr << "Invalid FIR design: order must be positive and cutoffs inside (0, fs/2)." << std::endl;
+        return std::vector<double>();
+    }
+
+    switch (spec.type) {
+    case FilterType::HighPass: {
+        if (spec.filterOrder % 2 != 0) {
+            std::cerr << "High-pass FIR designs require an even filter order." << std::endl;
+            return std::vector<double>();
+        }
+        // Spectral inversion of the low-pass prototype
+        std::vector<double> coefficients = designWindowedSincLowPass(spec.lowCutoff, spec);
+        for (auto& value : coefficients) {
+            value = -value;
+        }
+        coefficients[spec.filterOrder / 2] += 1.0;
+        return coefficients;
+    }
+    case FilterType::BandPass: {
+        if (spec.highCutoff <= spec.lowCutoff || spec.highCutoff >= nyquist) {
+            std::cerr << "Band-pass FIR designs require lowCutoff < highCutoff < fs/2." << std::endl;
+            return std::vector<double>();
+        }
+        // Difference of two low-pass prototypes
+        std::vector<double> coefficients = designWindowedSincLowPass(spec.highCutoff, spec);
+        std::vector<double> lower = designWindowedSincLowPass(spec.lowCutoff, spec);
+        for (int n = 0; n <= spec.filterOrder; ++n) {
+            coefficients[n] -= lower[n];
+        }
+        return coefficients;
+    }
+    default:
+        return designWindowedSincLowPass(spec.lowCutoff, spec);
+    }
+}
+
+// Thread-safe cache of windowed-sinc designs keyed by their full design spec.
+// When constructed with a filename the cache is loaded from that file, and
+// save() writes every design back so later runs skip the design step.
+class FIRDesignCache {
+public:
+    explicit FIRDesignCache(const std::string& filename = "") : filename_(filename) {
+        if (!filename_.empty()) {
+            load();
+        }
+    }
+
+    // Function to return the coefficients for spec, designing them on first use
+    std::vector<double> get(const FIRDesignSpec& spec) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = designs_.find(spec);
+            if (it != designs_.end()) {
+                return it->second;
+            }
+        }
+
+        // Design outside the lock so other threads are not blocked meanwhile
+        std::vector<double> coefficients = designWindowedSincFIR(spec);
+        if (coefficients.empty()) {
+            return coefficients;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        return designs_.emplace(spec, coefficients).first->second;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return designs_.size();
+    }
+
+    // Function to write all cached designs to the cache file
+    bool save() const {
+        if (filename_.empty()) {
+            return false;
+        }
+
+        std::ofstream file(filename_);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open the file: " << filename_ << std::endl;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        file << std::setprecision(17);
+        for (const auto& entry : designs_) {
+            const FIRDesignSpec& spec = entry.first;
+            file << static_cast<int>(spec.type) << ' ' << spec.lowCutoff << ' ' << spec.highCutoff << ' '
+                 << spec.samplingRate << ' ' << spec.filterOrder << ' ' << static_cast<int>(spec.window) << ' '
+                 << spec.kaiserBeta << ' ' << entry.second.size();
+            for (const auto& value : entry.second) {
+                file << ' ' << value;
+            }
+            file << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+
+private:
+    // Function to read designs from the cache file; a missing file is not an error
+    void load() {
+        std::ifstream file(filename_);
+        if (!file.is_open()) {
+            return;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::stringstream ss(line);
+            FIRDesignSpec spec;
+            int type = 0;
+            int window = 0;
+            std::size_t numTaps = 0;
+            if (!(ss >> type >> spec.lowCutoff >> spec.highCutoff >> spec.samplingRate >> spec.filterOrder >> window
+                     >> spec.kaiserBeta >> numTaps)) {
+                std::cerr << "Skipping malformed entry in FIR design cache: " << filename_ << std::endl;
+                continue;
+            }
+            spec.type = static_cast<FilterType>(type);
+            spec.window = static_cast<WindowType>(window);
+
+            std::vector<double> coefficients(numTaps);
+            for (auto& value : coefficients) {
+                ss >> value;
+            }
+            if (!ss || numTaps != static_cast<std::size_t>(spec.filterOrder) + 1) {
+                std::cerr << "Skipping malformed entry in FIR design cache: " << filename_ << std::endl;
+                continue;
+            }
+            designs_[spec] = coefficients;
+        }
+    }
+
+    std::string filename_;
+    mutable std::mutex mutex_;
+    std::map<FIRDesignSpec, std::vector<double>> designs_;
+};
+
+// Function to convolve the data with the filter coefficients in the time domain
+std::vector<double> convolveDirect(const std::vector<double>& data, const std::vector<double>& coefficients) {
     int numSamples = data.size();
+    int filterOrder = static_cast<int>(coefficients.size()) - 1;
     std::vector<double> filteredData(numSamples);
 
-    // Compute the filter coefficients
-    int filterOrder = static_cast<int>(std::ceil(0.45 * samplingRate / cutoffFrequency));
-    std::vector<double> filterCoefficients(filterOrder + 1, 1.0 / (filterOrder + 1));
+    for (int i = 0; i < numSamples; ++i) {
+        // Only taps that reach back into the signal contribute
+        int lastTap = std::min(i, filterOrder);
+        double sum = 0.0;
+        for (int j = 0; j <= lastTap; ++j) {
+            sum += coefficients[j] * data[i - j];
+        }
+        filteredData[i] = sum;
+    }
+
+    return filteredData;
+}
+
+// Function to pick the FFT size for overlap-save: a power of two of at least
+// four times the tap count, so each block yields >= 3/4 of its length as output
+int chooseOverlapSaveFFTSize(int numTaps) {
+    int fftSize = 256;
+    while (fftSize < 4 * numTaps) {
+        fftSize *= 2;
+    }
+    return fftSize;
+}
+
+// Function to convolve the data with the filter coefficients using overlap-save
+std::vector<double> convolveOverlapSave(const std::vector<double>& data, const std::vector<double>& coefficients) {
+    int numSamples = data.size();
+    int numTaps = coefficients.size();
+    std::vector<double> filteredData(numSamples);
+    if (numSamples == 0 || numTaps == 0) {
+        return filteredData;
+    }
+
+    int fftSize = chooseOverlapSaveFFTSize(numTaps);
+    int blockSize = fftSize - numTaps + 1;   // New output samples per block
+    int spectrumSize = fftSize / 2 + 1;
+
+    Eigen::FFT<double> fft;
+    fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+
+    // Transform the zero-padded filter once
+    std::vector<double> segment(fftSize, 0.0);
+    std::copy(coefficients.begin(), coefficients.end(), segment.begin());
+    std::vector<std::complex<double>> filterSpectrum(spectrumSize);
+    fft.fwd(filterSpectrum.data(), segment.data(), fftSize);
+
+    std::vector<std::complex<double>> blockSpectrum(spectrumSize);
+    std::vector<double> blockOutput(fftSize);
+
+    for (int start = 0; start < numSamples; start += blockSize) {
+        // Each segment carries numTaps - 1 samples of history before the block,
+        // which are zero before the start of the signal
+        for (int k = 0; k < fftSize; ++k) {
+            int index = start - (numTaps - 1) + k;
+            segment[k] = (index >= 0 && index < numSamples) ? data[index] : 0.0;
+        }
+
+        fft.fwd(blockSpectrum.data(), segment.data(), fftSize);
+        for (int k = 0; k < spectrumSize; ++k) {
+            blockSpectrum[k] *= filterSpectrum[k];
+        }
+        fft.inv(blockOutput.data(), blockSpectrum.data(), fftSize);
+
+        // The first numTaps - 1 outputs are wrapped around and discarded
+        int count = std::min(blockSize, numSamples - start);
+        std::copy(blockOutput.begin() + (numTaps - 1), blockOutput.begin() + (numTaps - 1) + count,
+                  filteredData.begin() + start);
+    }
+
+    return filteredData;
+}
+
+// Function to check whether all filter taps share the same value (boxcar)
+bool hasUniformCoefficients(const std::vector<double>& coefficients) {
+    for (const auto& value : coefficients) {
+        if (value != coefficients.front()) {
+            return false;
+        }
+    }
+    return !coefficients.empty();
+}
+
+// Function to add a value to a running sum with Kahan compensation
+inline void compensatedAdd(double& sum, double& compensation, double value) {
+    double y = value - compensation;
+    double t = sum + y;
+    compensation = (t - sum) - y;
+    sum = t;
+}
+
+// Function to apply a moving average of windowLength samples, each weighted by
+// tapWeight, using a running sum so that every sample costs O(1). With
+// compensated summation the rounding error of the running sum does not grow
+// with the signal length.
+std::vector<double> applyMovingAverage(const std::vector<double>& data, int windowLength, double tapWeight,
+                                       bool compensated = true) {
+    int numSamples = data.size();
+    std::vector<double> filteredData(numSamples);
+    double sum = 0.0;
+    double compensation = 0.0;
 
-    // Apply the filter
     for (int i = 0; i < numSamples; ++i) {
-        for (int j = 0; j <= filterOrder; ++j) {
-            if (i - j >= 0) {
-                filteredData[i] += filterCoefficients[j] * data[i - j];
+        if (compensated) {
+            compensatedAdd(sum, compensation, data[i]);
+            if (i >= windowLength) {
+                compensatedAdd(sum, compensation, -data[i - windowLength]);
+            }
+        } else {
+            sum += data[i];
+            if (i >= windowLength) {
+                sum -= data[i - windowLength];
             }
         }
+        filteredData[i] = tapWeight * sum;
     }
 
     return filteredData;
 }
 
-int main() {
+// Function to apply a cascade of identical moving averages (CIC-style
+// smoothing). Each stage multiplies the sinc-shaped response again, which
+// deepens the stopband while keeping the cost at O(stages) per sample.
+std::vector<double> applyCascadedMovingAverage(const std::vector<double>& data, int windowLength, int stages,
+                                               bool compensated = true) {
+    std::vector<double> filteredData = data;
+    for (int stage = 0; stage < stages; ++stage) {
+        filteredData = applyMovingAverage(filteredData, windowLength, 1.0 / windowLength, compensated);
+    }
+    return filteredData;
+}
+
+// Function to apply an FIR filter with the given coefficients
+std::vector<double> applyFIRFilter(const std::vector<double>& data, const std::vector<double>& coefficients,
+                                   FIRMode mode = FIRMode::Automatic) {
+    if (mode == FIRMode::Automatic) {
+        // The running sum rounds differently from the tap-by-tap sum, so it is
+        // opt-in only and short filters keep matching StreamingFIRFilter exactly
+        bool longFilter = static_cast<int>(coefficients.size()) >= kFFTTapThreshold;
+        mode = (longFilter && data.size() > coefficients.size()) ? FIRMode::FFT : FIRMode::Direct;
+    }
+
+    if (mode == FIRMode::MovingAverage) {
+        if (!hasUniformCoefficients(coefficients)) {
+            std::cerr << "Moving average mode requires uniform filter coefficients." << std::endl;
+            return std::vector<double>();
+        }
+        return applyMovingAverage(data, coefficients.size(), coefficients.front());
+    }
+    if (mode == FIRMode::FFT) {
+        return convolveOverlapSave(data, coefficients);
+    }
+    return convolveDirect(data, coefficients);
+}
+
+// Function to apply an FIR low-pass filter
+std::vector<double> applyFIRLowPassFilter(const std::vector<double>& data, double cutoffFrequency, double samplingRate,
+                                          FIRMode mode = FIRMode::Automatic) {
+    // Compute the filter coefficients
+    std::vector<double> filterCoefficients = computeFIRLowPassCoefficients(cutoffFrequency, samplingRate);
+
+    // Apply the filter
+    return applyFIRFilter(data, filterCoefficients, mode);
+}
+
+// Stateful FIR filter that convolves the way applyFIRFilter does in automatic
+// mode: directly for short filters and in overlap-save FFT blocks from
+// kFFTTapThreshold taps on, with the same block boundaries. Filtered samples
+// are passed to onOutput(values, count) as they become available. An FFT block
+// is only transformed once it is full, so its output lags the input by up to
+// one block, and finish() flushes the rest at the end of the signal. The
+// concatenated output matches one applyFIRFilter (or applyFIRLowPassFilter)
+// call on the joined input bit for bit.
+class StreamingBlockFIRFilter {
+public:
+    explicit StreamingBlockFIRFilter(const std::vector<double>& coefficients)
+        : coefficients_(coefficients), direct_(coefficients), numTaps_(static_cast<int>(coefficients.size())) {
+        if (numTaps_ < kFFTTapThreshold) {
+            return;
+        }
+        useFFT_ = true;
+        fftSize_ = chooseOverlapSaveFFTSize(numTaps_);
+        blockSize_ = fftSize_ - numTaps_ + 1;
+        fft_.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+
+        // Transform the zero-padded filter once, as convolveOverlapSave does
+        segment_.assign(fftSize_, 0.0);
+        std::copy(coefficients_.begin(), coefficients_.end(), segment_.begin());
+        filterSpectrum_.resize(fftSize_ / 2 + 1);
+        fft_.fwd(filterSpectrum_.data(), segment_.data(), fftSize_);
+        std::fill(segment_.begin(), segment_.end(), 0.0);
+        blockSpectrum_.resize(fftSize_ / 2 + 1);
+        blockOutput_.resize(fftSize_);
+    }
+
+    // Function to filter count samples, passing finished output to onOutput
+    template <typename OutputHandler>
+    void process(const double* input, std::size_t count, OutputHandler onOutput) {
+        samplesSeen_ += count;
+        if (!useFFT_) {
+            scratch_.resize(count);
+            direct_.process(input, count, scratch_.data());
+            onOutput(scratch_.data(), count);
+            return;
+        }
+
+        // New samples follow the numTaps - 1 samples of history in the segment
+        const std::size_t history = numTaps_ - 1;
+        while (count > 0) {
+            std::size_t take = std::min(count, blockSize_ - pending_);
+            std::copy(input, input + take, segment_.begin() + history + pending_);
+            pending_ += take;
+            input += take;
+            count -= take;
+            if (pending_ == blockSize_) {
+                transformBlock();
+                onOutput(blockOutput_.data() + history, blockSize_);
+                // The last numTaps - 1 samples are the next block's history
+                std::copy(segment_.begin() + blockSize_, segment_.end(), segment_.begin());
+                pending_ = 0;
+            }
+        }
+    }
+
+    // Function to flush the samples of a partly filled block at the end of the signal
+    template <typename OutputHandler>
+    void finish(OutputHandler onOutput) {
+        if (!useFFT_ || pending_ == 0) {
+            return;
+        }
+        const std::size_t history = numTaps_ - 1;
+        if (samplesSeen_ <= coefficients_.size()) {
+            // applyFIRFilter convolves signals no longer than the filter directly;
+            // no block has been emitted yet, so the direct filter is still fresh
+            scratch_.resize(pending_);
+            direct_.process(segment_.data() + history, pending_, scratch_.data());
+            onOutput(scratch_.data(), pending_);
+        } else {
+            std::fill(segment_.begin() + history + pending_, segment_.end(), 0.0);
+            transformBlock();
+            onOutput(blockOutput_.data() + history, pending_);
+        }
+        pending_ = 0;
+    }
+
+private:
+    void transformBlock() {
+        fft_.fwd(blockSpectrum_.data(), segment_.data(), fftSize_);
+        for (std::size_t k = 0; k < blockSpectrum_.size(); ++k) {
+            blockSpectrum_[k] *= filterSpectrum_[k];
+        }
+        fft_.inv(blockOutput_.data(), blockSpectrum_.data(), fftSize_);
+    }
+
+    std::vector<double> coefficients_;
+    StreamingFIRFilter direct_;
+    int numTaps_;
+    bool useFFT_ = false;
+    int fftSize_ = 0;
+    std::size_t blockSize_ = 0;      // New samples per FFT block
+    std::size_t pending_ = 0;        // New samples in the current block
+    std::size_t samplesSeen_ = 0;
+    Eigen::FFT<double> fft_;
+    std::vector<double> segment_;    // numTaps - 1 samples of history, then the block
+    std::vector<std::complex<double>> filterSpectrum_;
+    std::vector<std::complex<double>> blockSpectrum_;
+    std::vector<double> blockOutput_;
+    std::vector<double> scratch_;
+};
+
+// Function to filter and downsample by an integer factor in one pass. Only the
+// kept outputs y[m * decimationFactor] are computed, each as the full direct
+// convolution sum at that sample, so the discarded outputs cost nothing and
+// the work drops by decimationFactor. The result equals every
+// decimationFactor-th sample of the direct filter bit for bit.
+std::vector<double> decimateFIR(const std::vector<double>& data, const std::vector<double>& coefficients,
+                                int decimationFactor) {
+    if (decimationFactor < 1) {
+        std::cerr << "Decimation factor must be at least 1." << std::endl;
+        return std::vector<double>();
+    }
+
+    int numSamples = data.size();
+    int filterOrder = static_cast<int>(coefficients.size()) - 1;
+    int numOutputs = (numSamples + decimationFactor - 1) / decimationFactor;
+    std::vector<double> decimatedData(numOutputs);
+
+    for (int m = 0; m < numOutputs; ++m) {
+        int i = m * decimationFactor;
+        int lastTap = std::min(i, filterOrder);
+        double sum = 0.0;
+        for (int j = 0; j <= lastTap; ++j) {
+            sum += coefficients[j] * data[i - j];
+        }
+        decimatedData[m] = sum;
+    }
+
+    return decimatedData;
+}
+
+// Function to upsample by an integer factor and filter in one pass. The
+// coefficients are split into interpolationFactor sub-filters
+// h_p[k] = h[k * interpolationFactor + p], so output sample
+// y[n * interpolationFactor + p] is the p-th sub-filter applied to the input
+// and the zeros of the upsampled signal are never multiplied. Use
+// coefficients with a DC gain of interpolationFactor to preserve amplitude.
+std::vector<double> interpolateFIR(const std::vector<double>& data, const std::vector<double>& coefficients,
+                                   int interpolationFactor) {
+    if (interpolationFactor < 1) {
+        std::cerr << "Interpolation factor must be at least 1." << std::endl;
+        return std::vector<double>();
+    }
+
+    int numSamples = data.size();
+    int numTaps = coefficients.size();
+
+    // Split the filter into its polyphase components
+    std::vector<std::vector<double>> subFilters(interpolationFactor);
+    for (int j = 0; j < numTaps; ++j) {
+        subFilters[j % interpolationFactor].push_back(coefficients[j]);
+    }
+
+    std::vector<double> interpolatedData(static_cast<std::size_t>(numSamples) * interpolationFactor);
+    for (int n = 0; n < numSamples; ++n) {
+        for (int p = 0; p < interpolationFactor; ++p) {
+            const std::vector<double>& subFilter = subFilters[p];
+            int lastTap = std::min(n, static_cast<int>(subFilter.size()) - 1);
+            double sum = 0.0;
+            for (int k = 0; k <= lastTap; ++k) {
+                sum += subFilter[k] * data[n - k];
+            }
+            interpolatedData[static_cast<std::size_t>(n) * interpolationFactor + p] = sum;
+        }
+    }
+
+    return interpolatedData;
+}
+
+// Function to read a CSV file with one row per time step and one column per channel
+MultiChannelSignal readMultiChannelCSV(const std::string& filename) {
+    MultiChannelSignal signal;
+    std::vector<SignalParseError> errors;
+    if (!readSignalColumns(filename, signal, errors)) {
+        return signal;
+    }
+    if (!errors.empty()) {
+        reportSignalParseErrors(filename, errors);
+        return MultiChannelSignal();
+    }
+    return signal;
+}
+
+// Function to write a multi-channel signal to a CSV file, one row per time step
+void writeMultiChannelCSV(const std::string& filename, const MultiChannelSignal& signal) {
+    writeSignalColumns(filename, signal);
+}
+
+// Function to filter the warm-up samples [0, sampleEnd), where the window
+// still reaches past the start of the signal and the taps must be bounded
+void firMultiChannelWarmUp(const double* x, double* y, int numChannels, std::ptrdiff_t sampleEnd,
+                           const double* h, int numTaps) {
+    for (std::ptrdiff_t i = 0; i < sampleEnd; ++i) {
+        int lastTap = static_cast<int>(std::min<std::ptrdiff_t>(i, numTaps - 1));
+        for (int c = 0; c < numChannels; ++c) {
+            double sum = 0.0;
+            for (int j = 0; j <= lastTap; ++j) {
+                sum += h[j] * x[(i - j) * numChannels + c];
+            }
+            y[i * numChannels + c] = sum;
+        }
+    }
+}
+
+// Function to filter channels [channelBegin, channelEnd) over samples where all
+// taps are inside the signal, so the inner loop carries no edge checks
+void firMultiChannelScalar(const double* x, double* y, int numChannels, int channelBegin, int channelEnd,
+                           std::ptrdiff_t sampleBegin, std::ptrdiff_t sampleEnd, const double* h, int numTaps) {
+    for (std::ptrdiff_t i = sampleBegin; i < sampleEnd; ++i) {
+        for (int c = channelBegin; c < channelEnd; ++c) {
+            const double* newest = x + i * numChannels + c;
+            double sum = 0.0;
+            for (int j = 0; j < numTaps; ++j) {
+                sum += h[j] * newest[-static_cast<std::ptrdiff_t>(j) * numChannels];
+            }
+            y[i * numChannels + c] = sum;
+        }
+    }
+}
+
+#ifdef SIMD_HAVE_X86_DISPATCH
+// AVX2 kernel: four channels per vector, four time steps per pass so each
+// broadcast tap feeds four independent FMA chains
+__attribute__((target("avx2,fma")))
+void firMultiChannelAVX2(const double* x, double* y, int numChannels, std::ptrdiff_t sampleBegin,
+                         std::ptrdiff_t sampleEnd, const double* h, int numTaps) {
+    const std::ptrdiff_t stride = numChannels;
+    int vectorChannels = numChannels - numChannels % 4;
+
+    for (int c = 0; c < vectorChannels; c += 4) {
+        std::ptrdiff_t i = sampleBegin;
+        for (; i + 4 <= sampleEnd; i += 4) {
+            __m256d acc0 = _mm256_setzero_pd();
+            __m256d acc1 = _mm256_setzero_pd();
+            __m256d acc2 = _mm256_setzero_pd();
+            __m256d acc3 = _mm256_setzero_pd();
+            const double* newest = x + i * stride + c;
+            for (int j = 0; j < numTaps; ++j) {
+                __m256d tap = _mm256_broadcast_sd(&h[j]);
+                const double* row = newest - j * stride;
+                acc0 = _mm256_fmadd_pd(tap, _mm256_loadu_pd(row), acc0);
+                acc1 = _mm256_fmadd_pd(tap, _mm256_loadu_pd(row + stride), acc1);
+                acc2 = _mm256_fmadd_pd(tap, _mm256_loadu_pd(row + 2 * stride), acc2);
+                acc3 = _mm256_fmadd_pd(tap, _mm256_loadu_pd(row + 3 * stride), acc3);
+            }
+            double* out = y + i * stride + c;
+            _mm256_storeu_pd(out, acc0);
+            _mm256_storeu_pd(out + stride, acc1);
+            _mm256_storeu_pd(out + 2 * stride, acc2);
+            _mm256_storeu_pd(out + 3 * stride, acc3);
+        }
+        for (; i < sampleEnd; ++i) {
+            __m256d acc = _mm256_setzero_pd();
+            const double* newest = x + i * stride + c;
+            for (int j = 0; j < numTaps; ++j) {
+                acc = _mm256_fmadd_pd(_mm256_broadcast_sd(&h[j]), _mm256_loadu_pd(newest - j * stride), acc);
+            }
+            _mm256_storeu_pd(y + i * stride + c, acc);
+        }
+    }
+
+    firMultiChannelScalar(x, y, numChannels, vectorChannels, numChannels, sampleBegin, sampleEnd, h, numTaps);
+}
+
+// AVX-512 kernel: same scheme as the AVX2 kernel with eight channels per vector
+__attribute__((target("avx512f")))
+void firMultiChannelAVX512(const double* x, double* y, int numChannels, std::ptrdiff_t sampleBegin,
+                           std::ptrdiff_t sampleEnd, const double* h, int numTaps) {
+    const std::ptrdiff_t stride = numChannels;
+    int vectorChannels = numChannels - numChannels % 8;
+
+    for (int c = 0; c < vectorChannels; c += 8) {
+        std::ptrdiff_t i = sampleBegin;
+        for (; i + 4 <= sampleEnd; i += 4) {
+            __m512d acc0 = _mm512_setzero_pd();
+            __m512d acc1 = _mm512_setzero_pd();
+            __m512d acc2 = _mm512_setzero_pd();
+            __m512d acc3 = _mm512_setzero_pd();
+            const double* newest = x + i * stride + c;
+            for (int j = 0; j < numTaps; ++j) {
+                __m512d tap = _mm512_set1_pd(h[j]);
+                const double* row = newest - j * stride;
+                acc0 = _mm512_fmadd_pd(tap, _mm512_loadu_pd(row), acc0);
+                acc1 = _mm512_fmadd_pd(tap, _mm512_loadu_pd(row + stride), acc1);
+                acc2 = _mm512_fmadd_pd(tap, _mm512_loadu_pd(row + 2 * stride), acc2);
+                acc3 = _mm512_fmadd_pd(tap, _mm512_loadu_pd(row + 3 * stride), acc3);
+            }
+            double* out = y + i * stride + c;
+            _mm512_storeu_pd(out, acc0);
+            _mm512_storeu_pd(out + stride, acc1);
+            _mm512_storeu_pd(out + 2 * stride, acc2);
+            _mm512_storeu_pd(out + 3 * stride, acc3);
+        }
+        for (; i < sampleEnd; ++i) {
+            __m512d acc = _mm512_setzero_pd();
+            const double* newest = x + i * stride + c;
+            for (int j = 0; j < numTaps; ++j) {
+                acc = _mm512_fmadd_pd(_mm512_set1_pd(h[j]), _mm512_loadu_pd(newest - j * stride), acc);
+            }
+            _mm512_storeu_pd(y + i * stride + c, acc);
+        }
+    }
+
+    firMultiChannelScalar(x, y, numChannels, vectorChannels, numChannels, sampleBegin, sampleEnd, h, numTaps);
+}
+#endif
+
+// Function to apply an FIR filter to every channel of a multi-channel signal.
+// The SIMD kernels use fused multiply-add, so results agree with the scalar
+// path to rounding error rather than bit for bit.
+MultiChannelSignal applyMultiChannelFIRFilter(const MultiChannelSignal& signal, const std::vector<double>& coefficients,
+                                              SIMDLevel level = detectSIMDLevel()) {
+    MultiChannelSignal filtered;
+    filtered.numChannels = signal.numChannels;
+    filtered.samples.assign(signal.samples.size(), 0.0);
+
+    std::ptrdiff_t numSamples = signal.numSamples();
+    int numTaps = coefficients.size();
+    if (numSamples == 0 || numTaps == 0) {
+        return filtered;
+    }
+
+    const double* x = signal.samples.data();
+    double* y = filtered.samples.data();
+    const double* h = coefficients.data();
+
+    // Samples before the first full window are handled once, outside the kernels
+    std::ptrdiff_t steadyBegin = std::min<std::ptrdiff_t>(numTaps - 1, numSamples);
+    firMultiChannelWarmUp(x, y, signal.numChannels, steadyBegin, h, numTaps);
+
+    switch (level) {
+#ifdef SIMD_HAVE_X86_DISPATCH
+    case SIMDLevel::AVX512:
+        firMultiChannelAVX512(x, y, signal.numChannels, steadyBegin, numSamples, h, numTaps);
+        break;
+    case SIMDLevel::AVX2:
+        firMultiChannelAVX2(x, y, signal.numChannels, steadyBegin, numSamples, h, numTaps);
+        break;
+#endif
+    default:
+        firMultiChannelScalar(x, y, signal.numChannels, 0, signal.numChannels, steadyBegin, numSamples, h, numTaps);
+        break;
+    }
+
+    return filtered;
+}
+
+// Function to low-pass filter a CSV file chunk by chunk without loading it whole
+bool filterCSVStream(const std::string& inputFilename, const std::string& outputFilename,
+                     double cutoffFrequency, double samplingRate, std::size_t chunkSize = 4096) {
+    SignalWriter writer(outputFilename);
+    if (!writer.isOpen()) {
+        return false;
+    }
+
+    // Long filters are convolved in FFT blocks, as applyFIRFilter would
+    StreamingBlockFIRFilter filter(computeFIRLowPassCoefficients(cutoffFrequency, samplingRate));
+    auto write = [&](const double* values, std::size_t count) { writer.writeColumn(values, count); };
+    std::vector<SignalParseError> errors;
+    bool anySamples = false;
+
+    bool opened = forEachSignalBlock(inputFilename, chunkSize, [&](const double* chunk, std::size_t count) {
+        filter.process(chunk, count, write);
+        anySamples = true;
+    }, errors);
+    filter.finish(write);
+
+    if (!errors.empty()) {
+        reportSignalParseErrors(inputFilename, errors);
+        return false;
+    }
+    return opened && anySamples && writer.flush();
+}
+
+// Function to low-pass filter a binary signal file into a binary output file.
+// Single-channel float64 samples are filtered straight out of the memory-mapped
+// input. Otherwise blocks of chunkSize samples are copied out (converted to
+// double), de-interleaved and filtered one channel at a time, each channel
+// with its own streaming filter. Long filters run in FFT blocks, whose output
+// is interleaved and written as it completes. The sampling rate recorded in
+// the file takes precedence over samplingRate when it is set.
+bool filterBinarySignal(const std::string& inputFilename, const std::string& outputFilename,
+                        double cutoffFrequency, double samplingRate, std::size_t chunkSize = 4096) {
+    BinarySignalFile input(inputFilename);
+    if (!input.isOpen()) {
+        return false;
+    }
+
+    const BinarySignalHeader& header = input.header();
+    int numChannels = static_cast<int>(header.numChannels);
+    if (header.samplingRate > 0.0) {
+        samplingRate = header.samplingRate;
+    }
+
+    BinarySignalWriter writer(outputFilename, numChannels, samplingRate, static_cast<SignalDType>(header.dtype));
+    if (!writer.isOpen()) {
+        return false;
+    }
+
+    std::vector<double> coefficients = computeFIRLowPassCoefficients(cutoffFrequency, samplingRate);
+    const double* samples = input.samples();  // nullptr unless the file holds float64
+    if (samples != nullptr && numChannels == 1) {
+        StreamingBlockFIRFilter filter(coefficients);
+        auto write = [&](const double* values, std::size_t count) { writer.write(values, count); };
+        for (std::size_t first = 0; first < header.numSamples; first += chunkSize) {
+            filter.process(samples + first, std::min<std::size_t>(chunkSize, header.numSamples - first), write);
+        }
+        filter.finish(write);
+        return writer.close();
+    }
+
+    std::vector<StreamingBlockFIRFilter> filters;
+    filters.reserve(numChannels);
+    for (int c = 0; c < numChannels; ++c) {
+        filters.emplace_back(coefficients);
+    }
+    std::vector<double> block(chunkSize * numChannels);
+    std::vector<double> channelInput(chunkSize);
+    std::vector<std::vector<double>> channelOutput(numChannels);
+    auto collect = [&](int c) {
+        return [&channelOutput, c](const double* values, std::size_t n) {
+            channelOutput[c].insert(channelOutput[c].end(), values, values + n);
+        };
+    };
+
+    // Every channel runs the same filter on the same counts, so all channels
+    // have the same number of finished samples after each step
+    auto writeFinished = [&]() {
+        std::size_t count = channelOutput[0].size();
+        block.resize(count * numChannels);
+        for (int c = 0; c < numChannels; ++c) {
+            for (std::size_t i = 0; i < count; ++i) {
+                block[i * numChannels + c] = channelOutput[c][i];
+            }
+            channelOutput[c].clear();
+        }
+        writer.write(block.data(), count * numChannels);
+    };
+
+    for (std::size_t first = 0; first < header.numSamples; first += chunkSize) {
+        std::size_t count = std::min<std::size_t>(chunkSize, header.numSamples - first);
+        block.resize(count * numChannels);
+        input.copySamples(first * numChannels, count * numChannels, block.data());
+
+        for (int c = 0; c < numChannels; ++c) {
+            for (std::size_t i = 0; i < count; ++i) {
+                channelInput[i] = block[i * numChannels + c];
+            }
+            filters[c].process(channelInput.data(), count, collect(c));
+        }
+        writeFinished();
+    }
+    for (int c = 0; c < numChannels; ++c) {
+        filters[c].finish(collect(c));
+    }
+    writeFinished();
+
+    return writer.close();
+}
+
+// Function to low-pass filter a text or binary signal file; the output is
+// written in the same format as the input
+bool filterSignalFile(const std::string& inputFilename, const std::string& outputFilename,
+                      double cutoffFrequency, double samplingRate) {
+    if (isBinarySignalFile(inputFilename)) {
+        return filterBinarySignal(inputFilename, outputFilename, cutoffFrequency, samplingRate);
+    }
+    return filterCSVStream(inputFilename, outputFilename, cutoffFrequency, samplingRate);
+}
+
+// Function to check that filtering a signal in uneven chunks reproduces one
+// applyFIRLowPassFilter call bit for bit, for a direct and an FFT-length filter
+bool checkStreamingFilter() {
+    const double samplingRate = 1000.0;
+    std::vector<double> signal(100000);
+    for (std::size_t i = 0; i < signal.size(); ++i) {
+        double t = i / samplingRate;
+        signal[i] = std::sin(2.0 * M_PI * 3.0 * t) + 0.5 * std::sin(2.0 * M_PI * 150.0 * t) + 1e-3 * (i % 7);
+    }
+
+    bool identical = true;
+    for (double cutoffFrequency : {50.0, 5.0}) {
+        std::vector<double> coefficients = computeFIRLowPassCoefficients(cutoffFrequency, samplingRate);
+        std::vector<double> expected = applyFIRLowPassFilter(signal, cutoffFrequency, samplingRate);
+
+        StreamingBlockFIRFilter filter(coefficients);
+        std::vector<double> streamed;
+        auto append = [&](const double* values, std::size_t count) {
+            streamed.insert(streamed.end(), values, values + count);
+        };
+        std::size_t first = 0;
+        for (std::size_t k = 0; first < signal.size(); ++k) {
+            std::size_t count = std::min<std::size_t>(1 + (k * 7919) % 3001, signal.size() - first);
+            filter.process(signal.data() + first, count, append);
+            first += count;
+        }
+        filter.finish(append);
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (i >= streamed.size() || streamed[i] != expected[i]) {
+                ++mismatches;
+            }
+        }
+        mismatches += streamed.size() > expected.size() ? streamed.size() - expected.size() : 0;
+        std::cout << "Streaming vs one-shot, " << coefficients.size() << " taps: " << mismatches << " of "
+                  << expected.size() << " samples differ" << std::endl;
+        identical = identical && mismatches == 0;
+    }
+    return identical;
+}
+
+int main(int argc, char* argv[]) {
     std::string inputFilename = "./data/signals.csv";
     std::string outputFilename = "./data/output.csv"; 
     double cutoffFrequency = 10.0;  // Default cutoff frequency in Hz
     double samplingRate = 1000.0;   // Default sampling rate in Hz
 
-    // Read data from the input CSV file
-    std::vector<double> inputData = readCSV(inputFilename);
-    if (inputData.empty()) {
-        return 1;
+    // Check that chunked streaming matches the one-shot filter: FIRFilter --check
+    if (argc >= 2 && std::string(argv[1]) == "--check") {
+        return checkStreamingFilter() ? 0 : 1;
     }
 
-    // Apply the FIR low-pass filter
-    std::vector<double> filteredData = applyFIRLowPassFilter(inputData, cutoffFrequency, samplingRate);
+    // Convert a text capture once so later runs can read it without parsing:
+    //   FIRFilter --convert signals.csv signals.bin [samplingRate]
+    if (argc >= 4 && std::string(argv[1]) == "--convert") {
+        double rate = (argc >= 5) ? std::atof(argv[4]) : samplingRate;
+        if (!convertTextSignalToBinary(argv[2], argv[3], rate)) {
+            return 1;
+        }
+        std::cout << "Conversion completed successfully!" << std::endl;
+        return 0;
+    }
 
-    // Write the filtered data to the output CSV file
-    writeCSV(outputFilename, filteredData);
+    // Input and output files may be given on the command line (text or binary)
+    if (argc >= 3) {
+        inputFilename = argv[1];
+        outputFilename = argv[2];
+    }
+
+    // Filter the input file chunk by chunk into the output file
+    if (!filterSignalFile(inputFilename, outputFilename, cutoffFrequency, samplingRate)) {
+        return 1;
+    }
 
     std::cout << "Filtering completed successfully!" << std::endl;
 
@@ -1,6 +1,11 @@
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
 #include <Eigen/Dense>
 
+#include "GaussSeidelSolver.h"
+
 /*
 Illuminated by:     "Solving systems of linear equations by Gauss-Seidel 
                      iteration" by Shiliang Xu 
@@ -43,6 +48,25 @@ od.
 */
 
 
+// Function to build the 5-point Laplacian on an n x n grid (Dirichlet boundary) in CSR form
+CSRMatrix buildPoissonMatrix(int n) {
+    std::vector<Eigen::Triplet<double>> entries;
+    entries.reserve(5 * static_cast<std::size_t>(n) * n);
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            int i = r * n + c;
+            entries.emplace_back(i, i, 4.0);
+            if (r > 0) entries.emplace_back(i, i - n, -1.0);
+            if (r < n - 1) entries.emplace_back(i, i + n, -1.0);
+            if (c > 0) entries.emplace_back(i, i - 1, -1.0);
+            if (c < n - 1) entries.emplace_back(i, i + 1, -1.0);
+        }
+    }
+    CSRMatrix A(n * n, n * n);
+    A.setFromTriplets(entries.begin(), entries.end());
+    return A;
+}
+
 int main() 
 {
     Eigen::MatrixXd A(4, 4); // Square matrix A
@@ -56,34 +80,40 @@ int main()
 
     b << 4, 7, -1, 0; 
 
-    Eigen::VectorXd x(4); // Vector x (unknowns)
-
-    // Gauss-Seidel iteration
-    int maxIterations = 100;
-    double tolerance = 1e-6;
-    int iterations = 0;
-    double error = tolerance + 1;
-
-    while (error > tolerance && iterations < maxIterations) {
-        Eigen::VectorXd x_new = x; 
-        for (int i = 0; i < A.rows(); ++i) {
-            double sum = 0.0;
-
-            for (int j = 0; j < A.cols(); ++j) {
-                if (j != i) {
-                    sum += A(i, j) * x(j);
-                }
-            }
-            x_new(i) = (b(i) - sum) / A(i, i);
-        } 
-        error = (x_new - x).norm();
-        x = x_new;
-        iterations++;
-    }
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(4); // Vector x (unknowns)
+
+    // Gauss-Seidel iteration, updating x in place on the sparse (CSR) matrix
+    RelaxationOptions options;
+    options.maxSweeps = 100;
+    options.tolerance = 1e-6;
+    options.residualCheckInterval = 1;
+    RelaxationResult result = solveRelaxation(A.sparseView(), b, x, options);
 
     // Print the solution
     std::cout << "Solution:\n";
     std::cout << x << "\n";
+    std::cout << "Sweeps: " << result.sweeps << ", relative residual: " << result.relativeResidual << "\n";
+
+    // A grid problem: SOR with the optimal omega, sequential and red-black parallel
+    int n = 300;
+    CSRMatrix poisson = buildPoissonMatrix(n);
+    Eigen::VectorXd rhs = Eigen::VectorXd::Ones(n * n);
+    const double pi = 3.14159265358979323846;
+
+    RelaxationOptions sor;
+    sor.omega = 2.0 / (1.0 + std::sin(pi / (n + 1)));
+    sor.maxSweeps = 5000;
+    sor.residualCheckInterval = 20;
+    for (int numThreads : {1, static_cast<int>(std::max(2u, std::thread::hardware_concurrency()))}) {
+        sor.numThreads = numThreads;
+        Eigen::VectorXd u = Eigen::VectorXd::Zero(n * n);
+        auto start = std::chrono::steady_clock::now();
+        RelaxationResult gridResult = solveRelaxation(poisson, rhs, u, sor);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << n << "x" << n << " grid, " << numThreads << " thread(s): " << gridResult.sweeps
+                  << " sweeps, relative residual " << gridResult.relativeResidual << ", "
+                  << seconds << " s\n";
+    }
 
     return 0;
-} 
\ No newline at end of file
+}
\ No newline at end of file
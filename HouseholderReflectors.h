@@ -0,0 +1,163 @@
+#ifndef HOUSEHOLDER_REFLECTORS_H
+#define HOUSEHOLDER_REFLECTORS_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <Eigen/Dense>
+
+/*
+Householder reflectors kept in implicit form.
+
+A reflector H = I - tau v v^T is stored as the pair (v, tau),
+never as an n x n matrix. Applying it to a vector,
+
+    H y = y - tau v (v^T y),
+
+is one dot product and one axpy: O(n) time and no extra memory.
+As in LAPACK, v(start) = 1 and v is zero above start, so a
+reflector can act on the trailing rows only, as in a QR
+factorization.
+
+A product of k reflectors Q = H_1 H_2 ... H_k has the compact WY
+form
+
+    Q = I - V T V^T,
+
+where V (n x k) holds the vectors and T (k x k) is upper
+triangular (LAPACK dlarft). Applying Q or Q^T to an n x m matrix
+then takes two matrix products and one triangular product,
+
+    W = V^T A,   W = T W (or T^T W),   A = A - V W,
+
+which are level-3 operations that run at close to peak speed,
+whereas applying the reflectors one by one streams the whole of A
+through memory k times for only O(1) work per entry loaded.
+applyReflectorsBlocked cuts a long sequence into blocks of
+blockSize reflectors and applies each block in compact WY form.
+*/
+
+struct HouseholderReflector {
+    Eigen::VectorXd v;  // v(start) = 1, zero above start
+    double tau = 0.0;   // tau = 0 is the identity
+    int start = 0;
+};
+
+// Function to construct H with H x = beta e_start, acting on entries start.. of x (LAPACK dlarfg)
+inline HouseholderReflector makeHouseholderReflector(const Eigen::VectorXd& x, int start, double& beta) {
+    HouseholderReflector H;
+    const Eigen::Index n = x.size();
+    H.start = start;
+    H.v = Eigen::VectorXd::Zero(n);
+    H.v(start) = 1.0;
+
+    double alpha = x(start);
+    double tailNorm = x.tail(n - start - 1).norm();
+    if (tailNorm == 0.0) {
+        beta = alpha;  // Already a multiple of e_start: H = I
+        return H;
+    }
+    beta = -std::copysign(std::hypot(alpha, tailNorm), alpha);
+    H.tau = (beta - alpha) / beta;
+    H.v.tail(n - start - 1) = x.tail(n - start - 1) / (alpha - beta);
+    return H;
+}
+
+// Function to apply H to a vector in place in O(n)
+inline void applyReflector(const HouseholderReflector& H, Eigen::VectorXd& y) {
+    const Eigen::Index length = y.size() - H.start;
+    auto v = H.v.tail(length);
+    auto tail = y.tail(length);
+    tail -= (H.tau * v.dot(tail)) * v;
+}
+
+// Function to apply H to the columns of a matrix in place, A = H A
+inline void applyReflector(const HouseholderReflector& H, Eigen::MatrixXd& A) {
+    const Eigen::Index length = A.rows() - H.start;
+    auto v = H.v.tail(length);
+    auto rows = A.bottomRows(length);
+    Eigen::RowVectorXd w = v.transpose() * rows;
+    rows.noalias() -= H.tau * v * w;
+}
+
+// Q = H_1 H_2 ... H_k = I - V T V^T; rows of V above start are zero and not stored
+struct CompactWY {
+    Eigen::MatrixXd V;
+    Eigen::MatrixXd T;
+    int start = 0;
+};
+
+// Function to aggregate reflectors [first, first + count) into compact WY form (LAPACK dlarft)
+inline CompactWY makeCompactWY(const std::vector<HouseholderReflector>& reflectors, std::size_t first,
+                               std::size_t count) {
+    CompactWY wy;
+    const Eigen::Index k = static_cast<Eigen::Index>(count);
+    wy.start = reflectors[first].start;
+    for (std::size_t i = first; i < first + count; ++i) {
+        wy.start = std::min(wy.start, reflectors[i].start);
+    }
+    const Eigen::Index rows = reflectors[first].v.size() - wy.start;
+    wy.V.resize(rows, k);
+    wy.T = Eigen::MatrixXd::Zero(k, k);
+    for (Eigen::Index i = 0; i < k; ++i) {
+        const HouseholderReflector& H = reflectors[first + i];
+        wy.V.col(i) = H.v.tail(rows);
+        wy.T(i, i) = H.tau;
+        if (i > 0) {
+            // T(0:i, i) = -tau_i T(0:i, 0:i) V(:, 0:i)^T v_i
+            Eigen::VectorXd z = wy.V.leftCols(i).transpose() * wy.V.col(i);
+            Eigen::VectorXd column = wy.T.topLeftCorner(i, i).triangularView<Eigen::Upper>() * z;
+            wy.T.col(i).head(i) = -H.tau * column;
+        }
+    }
+    return wy;
+}
+
+// Function to apply Q (or Q^T if transpose is set) in compact WY form, A = Q A
+inline void applyCompactWY(const CompactWY& wy, Eigen::MatrixXd& A, bool transpose = false) {
+    auto rows = A.bottomRows(wy.V.rows());
+    Eigen::MatrixXd W = wy.V.transpose() * rows;
+    if (transpose) {
+        W = wy.T.transpose().triangularView<Eigen::Lower>() * W;
+    } else {
+        W = wy.T.triangularView<Eigen::Upper>() * W;
+    }
+    rows.noalias() -= wy.V * W;
+}
+
+// Function to apply Q = H_1 ... H_k (or Q^T) to A, blockSize reflectors at a time
+inline void applyReflectorsBlocked(const std::vector<HouseholderReflector>& reflectors, Eigen::MatrixXd& A,
+                                   bool transpose = false, std::size_t blockSize = 32) {
+    const std::size_t k = reflectors.size();
+    const std::size_t numBlocks = (k + blockSize - 1) / blockSize;
+    // Q A = H_1 (H_2 (... H_k A)) applies the last block first; Q^T A the first block first
+    for (std::size_t b = 0; b < numBlocks; ++b) {
+        std::size_t block = transpose ? b : numBlocks - 1 - b;
+        std::size_t first = block * blockSize;
+        CompactWY wy = makeCompactWY(reflectors, first, std::min(blockSize, k - first));
+        applyCompactWY(wy, A, transpose);
+    }
+}
+
+// Function to compute an unblocked Householder QR of A, overwriting A with R
+// and returning the reflectors, so that A_original = Q R with Q = H_1 ... H_k
+inline std::vector<HouseholderReflector> householderQR(Eigen::MatrixXd& A) {
+    std::vector<HouseholderReflector> reflectors;
+    const Eigen::Index k = std::min(A.rows(), A.cols());
+    for (Eigen::Index j = 0; j < k; ++j) {
+        double beta;
+        HouseholderReflector H = makeHouseholderReflector(A.col(j), static_cast<int>(j), beta);
+        // Only the columns to the right still need the reflector
+        Eigen::Index length = A.rows() - j;
+        auto v = H.v.tail(length);
+        auto trailing = A.bottomRightCorner(length, A.cols() - j - 1);
+        Eigen::RowVectorXd w = v.transpose() * trailing;
+        trailing.noalias() -= H.tau * v * w;
+        A(j, j) = beta;
+        A.col(j).tail(length - 1).setZero();
+        reflectors.push_back(std::move(H));
+    }
+    return reflectors;
+}
+
+#endif
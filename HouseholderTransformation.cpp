@@ -1,6 +1,9 @@
 #include <iostream>
+#include <chrono>
+#include <vector>
 #include <Eigen/Core>
-#include <Eigen/QR> 
+
+#include "HouseholderReflectors.h"
 
 using namespace Eigen; 
 
@@ -13,15 +16,23 @@ Publication Date:   May 2019
 Date:               Sep. 03 2023  
 */
 
+/*
+The reflection of x through the hyperplane orthogonal to v is
+
+    y = H x,   H = I - 2 v v^T / (v^T v),
+
+which is applied implicitly as y = x - (2 v^T x / v^T v) v, in
+O(n) time without forming H (see HouseholderReflectors.h).
+*/
+
 void applyHouseholderTransformation(const VectorXd& x, const VectorXd& v, VectorXd& y)
 {
-    HouseholderQR<MatrixXd> qr(x.size(), v.size());
-    // Set Q to identity 
-    MatrixXd Q = MatrixXd::Identity(x.size(), x.size());
-  
-    Q.applyOnTheLeft(v);
+    HouseholderReflector H;
+    H.v = v;
+    H.tau = 2.0 / v.squaredNorm();
 
-    y = Q * x.asDiagonal();  
+    y = x;
+    applyReflector(H, y);
 }
 
 int main()
@@ -33,19 +44,53 @@ int main()
     VectorXd v(4);
     v << 1, 1, 1, 1;
 
-    HouseholderQR<MatrixXd> qr(x.size(), v.size());
-  
-    MatrixXd Q = MatrixXd::Identity(x.size(), x.size());
-
     // Calculate the reflected vector y
     VectorXd y;
     applyHouseholderTransformation(x, v, y);
 
+    // H itself, only for display: the reflection of each unit vector
+    MatrixXd Q = MatrixXd::Identity(x.size(), x.size());
+    for (int j = 0; j < Q.cols(); ++j) {
+        VectorXd column = Q.col(j);
+        applyHouseholderTransformation(column, v, column);
+        Q.col(j) = column;
+    }
+
     // Print the results
     std::cout << "x: " << x.transpose() << std::endl;
     std::cout << "v: " << v.transpose() << std::endl;
     std::cout << "H:\n" << Q << std::endl; 
     std::cout << "y: " << y.transpose() << std::endl;
 
+    // Reflectors from a QR factorization applied one by one and in compact WY blocks
+    const int n = 2000;
+    const int k = 256;
+    MatrixXd A = MatrixXd::Random(n, k);
+    MatrixXd R = A;
+    std::vector<HouseholderReflector> reflectors = householderQR(R);
+
+    MatrixXd B = MatrixXd::Random(n, 1000);
+    MatrixXd oneByOne = B;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& H : reflectors) {
+        applyReflector(H, oneByOne);  // Q^T B = H_k ... H_1 B
+    }
+    double unblockedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    MatrixXd blocked = B;
+    start = std::chrono::steady_clock::now();
+    applyReflectorsBlocked(reflectors, blocked, true);
+    double blockedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Q^T B with " << k << " reflectors: one by one " << unblockedSeconds << " s, compact WY "
+              << blockedSeconds << " s, difference " << (blocked - oneByOne).norm() / oneByOne.norm()
+              << std::endl;
+
+    // Q R reproduces A
+    MatrixXd QR = MatrixXd::Zero(n, k);
+    QR.topRows(k) = R.topRows(k);
+    applyReflectorsBlocked(reflectors, QR);
+    std::cout << "||QR - A|| / ||A|| = " << (QR - A).norm() / A.norm() << std::endl;
+
     return 0;
-} 
\ No newline at end of file
+}
\ No newline at end of file
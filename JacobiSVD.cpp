@@ -1,4 +1,9 @@
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
 #include <Eigen/Dense>
 
 /*
@@ -20,6 +25,187 @@ void setSmallValuesToZero(Eigen::MatrixXd& matrix, double epsilon) {
   }
 }
 
+/*
+Randomized truncated SVD (Halko, Martinsson and Tropp, 2011).
+
+A full JacobiSVD costs O(m n^2) with a large constant even when
+only the top k singular triplets of a tall m x n matrix are
+needed. The randomized range finder gets them with a few passes
+over A:
+
+1. Y = A Omega for a Gaussian n x l test matrix, l = k + p; the
+   oversampling p (about 10) makes it very likely that Y captures
+   the top-k range of A.
+2. q power iterations Y = A (A^T Y), re-orthonormalized each time,
+   sharpen a slowly decaying spectrum (the error factor drops
+   from (sigma_{k+1}/sigma_k) to (sigma_{k+1}/sigma_k)^(2q+1)).
+3. Q = orth(Y), B = Q^T A (l x n), SVD of the small B = U_B S V^T,
+   and U = Q U_B.
+
+A is used only through the products A X and A^T X, so it can be
+given as a matrix-free callback. The cost is O(m n l) per pass.
+
+When A can be read only once (rows streamed from disk) the
+single-pass variant (Tropp et al., 2017) keeps two sketches,
+Y = A Omega (m x l) and W = Psi A (l2 x n) with l2 > l, plus Psi Y.
+Every chunk of rows updates all three, and Psi is generated chunk
+by chunk and never stored. At the end
+
+    Y = Q R,   Psi Q = (Psi Y) R^-1,   X = (Psi Q)^+ W,
+
+and the SVD of the small X gives the factors. It is less accurate
+than the multi-pass version, since it cannot use power iterations.
+
+Both return the thin U (m x k), the singular values (k) and V
+(n x k) through matrixU(), singularValues() and matrixV(), as
+JacobiSVD does.
+*/
+
+// The products Y = A X (matrix A, m x n) and Y = A^T X, supplied by the caller
+struct MatrixFreeOperator {
+  Eigen::Index rows = 0;
+  Eigen::Index cols = 0;
+  std::function<void(const Eigen::MatrixXd& X, Eigen::MatrixXd& Y)> multiply;
+  std::function<void(const Eigen::MatrixXd& X, Eigen::MatrixXd& Y)> multiplyTranspose;
+};
+
+// Function to return an orthonormal basis of the columns of Y (thin Q of a QR)
+Eigen::MatrixXd orthonormalBasis(const Eigen::MatrixXd& Y) {
+  Eigen::HouseholderQR<Eigen::MatrixXd> qr(Y);
+  return qr.householderQ() * Eigen::MatrixXd::Identity(Y.rows(), std::min(Y.rows(), Y.cols()));
+}
+
+// Function to fill a matrix with standard normal entries
+Eigen::MatrixXd gaussianMatrix(Eigen::Index rows, Eigen::Index cols, std::mt19937_64& generator) {
+  std::normal_distribution<double> normal(0.0, 1.0);
+  Eigen::MatrixXd G(rows, cols);
+  for (Eigen::Index j = 0; j < cols; ++j) {
+    for (Eigen::Index i = 0; i < rows; ++i) {
+      G(i, j) = normal(generator);
+    }
+  }
+  return G;
+}
+
+class RandomizedSVD {
+public:
+  RandomizedSVD(const MatrixFreeOperator& A, int rank, int oversampling = 10, int powerIterations = 2,
+                unsigned long long seed = 42) {
+    compute(A, rank, oversampling, powerIterations, seed);
+  }
+
+  RandomizedSVD(const Eigen::MatrixXd& A, int rank, int oversampling = 10, int powerIterations = 2,
+                unsigned long long seed = 42) {
+    MatrixFreeOperator op;
+    op.rows = A.rows();
+    op.cols = A.cols();
+    op.multiply = [&A](const Eigen::MatrixXd& X, Eigen::MatrixXd& Y) { Y.noalias() = A * X; };
+    op.multiplyTranspose = [&A](const Eigen::MatrixXd& X, Eigen::MatrixXd& Y) { Y.noalias() = A.transpose() * X; };
+    compute(op, rank, oversampling, powerIterations, seed);
+  }
+
+  const Eigen::MatrixXd& matrixU() const { return U_; }
+  const Eigen::VectorXd& singularValues() const { return singularValues_; }
+  const Eigen::MatrixXd& matrixV() const { return V_; }
+
+private:
+  void compute(const MatrixFreeOperator& A, int rank, int oversampling, int powerIterations,
+               unsigned long long seed) {
+    Eigen::Index l = std::min<Eigen::Index>(rank + oversampling, std::min(A.rows, A.cols));
+    std::mt19937_64 generator(seed);
+
+    // Range finder with power iterations
+    Eigen::MatrixXd Y, Z;
+    A.multiply(gaussianMatrix(A.cols, l, generator), Y);
+    Eigen::MatrixXd Q = orthonormalBasis(Y);
+    for (int i = 0; i < powerIterations; ++i) {
+      A.multiplyTranspose(Q, Z);
+      A.multiply(orthonormalBasis(Z), Y);
+      Q = orthonormalBasis(Y);
+    }
+
+    // B^T = A^T Q is n x l; its thin SVD B^T = V_B S U_B^T gives B = U_B S V_B^T
+    Eigen::MatrixXd Bt;
+    A.multiplyTranspose(Q, Bt);
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(Bt, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    Eigen::Index k = std::min<Eigen::Index>(rank, svd.singularValues().size());
+    U_ = Q * svd.matrixV().leftCols(k);
+    singularValues_ = svd.singularValues().head(k);
+    V_ = svd.matrixU().leftCols(k);
+  }
+
+  Eigen::MatrixXd U_;
+  Eigen::VectorXd singularValues_;
+  Eigen::MatrixXd V_;
+};
+
+// Single-pass randomized SVD over row chunks of a tall matrix
+class StreamingRandomizedSVD {
+public:
+  StreamingRandomizedSVD(Eigen::Index cols, int rank, int oversampling = 10, unsigned long long seed = 42)
+      : rank_(rank), generator_(seed) {
+    Eigen::Index l = std::min<Eigen::Index>(rank + oversampling, cols);
+    Eigen::Index l2 = 2 * l + 1;
+    omega_ = gaussianMatrix(cols, l, generator_);
+    W_ = Eigen::MatrixXd::Zero(l2, cols);
+    psiY_ = Eigen::MatrixXd::Zero(l2, l);
+  }
+
+  // Function to add the next rows of A (one pass, in order)
+  void addRows(const Eigen::MatrixXd& rows) {
+    Eigen::MatrixXd Ychunk = rows * omega_;
+    Eigen::MatrixXd psi = gaussianMatrix(W_.rows(), rows.rows(), generator_);
+    W_.noalias() += psi * rows;
+    psiY_.noalias() += psi * Ychunk;
+    // Chunks are joined once in finish(); growing Y here would copy it every time
+    numRows_ += Ychunk.rows();
+    Ychunks_.push_back(std::move(Ychunk));
+  }
+
+  // Function to compute the factors once all rows have been added
+  void finish() {
+    Eigen::MatrixXd Y(numRows_, omega_.cols());
+    Eigen::Index row = 0;
+    for (Eigen::MatrixXd& chunk : Ychunks_) {
+      Y.middleRows(row, chunk.rows()) = chunk;
+      row += chunk.rows();
+      chunk.resize(0, 0);
+    }
+    Ychunks_.clear();
+
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(Y);
+    Eigen::Index l = std::min(Y.rows(), Y.cols());
+    Eigen::MatrixXd Q = qr.householderQ() * Eigen::MatrixXd::Identity(Y.rows(), l);
+    Eigen::MatrixXd R = qr.matrixQR().topRows(l).triangularView<Eigen::Upper>();
+
+    // Psi Q = (Psi Y) R^-1, then X = (Psi Q)^+ W by least squares
+    Eigen::MatrixXd psiQ = R.transpose().triangularView<Eigen::Lower>().solve(psiY_.leftCols(l).transpose()).transpose();
+    Eigen::MatrixXd X = psiQ.colPivHouseholderQr().solve(W_);
+
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(X, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    Eigen::Index k = std::min<Eigen::Index>(rank_, svd.singularValues().size());
+    U_ = Q * svd.matrixU().leftCols(k);
+    singularValues_ = svd.singularValues().head(k);
+    V_ = svd.matrixV().leftCols(k);
+  }
+
+  const Eigen::MatrixXd& matrixU() const { return U_; }
+  const Eigen::VectorXd& singularValues() const { return singularValues_; }
+  const Eigen::MatrixXd& matrixV() const { return V_; }
+
+private:
+  int rank_;
+  std::mt19937_64 generator_;
+  Eigen::MatrixXd omega_;  // n x l test matrix
+  std::vector<Eigen::MatrixXd> Ychunks_;  // Row chunks of A Omega (m x l)
+  Eigen::Index numRows_ = 0;
+  Eigen::MatrixXd W_;      // Psi A, l2 x n
+  Eigen::MatrixXd psiY_;   // Psi Y, l2 x l
+  Eigen::MatrixXd U_;
+  Eigen::VectorXd singularValues_;
+  Eigen::MatrixXd V_;
+};
+
 int main() {
 
   // Input matrix
@@ -61,5 +247,67 @@ int main() {
   Eigen::MatrixXf reconstructedA = Umatrix * singularValuesVector.asDiagonal() * Vmatrix.transpose();
   std::cout << "Reconstructed A:\n" << reconstructedA << std::endl;
 
+  // A tall matrix with known singular values 100 / (j + 1) plus small noise
+  const int m = 20000;
+  const int n = 200;
+  const int k = 10;
+  std::mt19937_64 generator(7);
+  Eigen::MatrixXd U0 = orthonormalBasis(gaussianMatrix(m, n, generator));
+  Eigen::MatrixXd V0 = orthonormalBasis(gaussianMatrix(n, n, generator));
+  Eigen::VectorXd sigma(n);
+  for (int j = 0; j < n; ++j) {
+    sigma(j) = j < 2 * k ? 100.0 / (j + 1) : 0.01;
+  }
+  Eigen::MatrixXd tall = U0 * sigma.asDiagonal() * V0.transpose();
+
+  auto elapsed = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  RandomizedSVD rsvd(tall, k);
+  double randomizedSeconds = elapsed(start);
+  Eigen::MatrixXd residual = tall - rsvd.matrixU() * rsvd.singularValues().asDiagonal() * rsvd.matrixV().transpose();
+  std::cout << "Randomized SVD, top " << k << " of " << m << " x " << n << ": " << randomizedSeconds
+            << " s, max singular value error " << (rsvd.singularValues() - sigma.head(k)).cwiseAbs().maxCoeff()
+            << ", ||A - U S V^T|| relative to the best rank-" << k << " error "
+            << residual.norm() / sigma.tail(n - k).norm() << std::endl;
+
+  // Single pass over row chunks of the same matrix; with no power iterations
+  // to lean on, it needs more oversampling
+  start = std::chrono::steady_clock::now();
+  StreamingRandomizedSVD streaming(n, k, 40);
+  for (int first = 0; first < m; first += 10000) {
+    streaming.addRows(tall.middleRows(first, std::min(10000, m - first)));
+  }
+  streaming.finish();
+  std::cout << "Single-pass SVD: " << elapsed(start) << " s, max singular value error "
+            << (streaming.singularValues() - sigma.head(k)).cwiseAbs().maxCoeff() << std::endl;
+
+  // Matrix-free: the rank-20 matrix A = F G^T is applied through its factors and never formed
+  const int factorRank = 20;
+  Eigen::MatrixXd F = gaussianMatrix(m, factorRank, generator);
+  Eigen::MatrixXd G = gaussianMatrix(n, factorRank, generator);
+  MatrixFreeOperator product;
+  product.rows = m;
+  product.cols = n;
+  product.multiply = [&](const Eigen::MatrixXd& X, Eigen::MatrixXd& Y) { Y.noalias() = F * (G.transpose() * X); };
+  product.multiplyTranspose = [&](const Eigen::MatrixXd& X, Eigen::MatrixXd& Y) { Y.noalias() = G * (F.transpose() * X); };
+  RandomizedSVD matrixFree(product, factorRank);
+
+  // Reference without forming A either: with F = Q1 R1 and G = Q2 R2,
+  // A = Q1 (R1 R2^T) Q2^T has the singular values of the small R1 R2^T
+  Eigen::MatrixXd R1 = F.householderQr().matrixQR().topRows(factorRank).triangularView<Eigen::Upper>();
+  Eigen::MatrixXd R2 = G.householderQr().matrixQR().topRows(factorRank).triangularView<Eigen::Upper>();
+  Eigen::JacobiSVD<Eigen::MatrixXd> exact(R1 * R2.transpose());
+  std::cout << "Matrix-free SVD: max relative singular value error "
+            << ((matrixFree.singularValues() - exact.singularValues().head(factorRank)).array()
+                / exact.singularValues().head(factorRank).array()).abs().maxCoeff() << std::endl;
+
+  // Full JacobiSVD on a tenth of the rows, for comparison
+  start = std::chrono::steady_clock::now();
+  Eigen::JacobiSVD<Eigen::MatrixXd> full(tall.topRows(m / 10), Eigen::ComputeThinU | Eigen::ComputeThinV);
+  std::cout << "JacobiSVD on " << m / 10 << " x " << n << ": " << elapsed(start) << " s" << std::endl;
+
   return 0;
 } 
\ No newline at end of file
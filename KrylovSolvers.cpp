@@ -0,0 +1,118 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include "GaussSeidelSolver.h"
+#include "KrylovSolvers.h"
+
+/*
+Demonstration of the Krylov solvers in KrylovSolvers.h on grid
+problems of the kind the stationary iterations of
+GaussSeidelIteration.cpp handle poorly:
+
+- the 2D Poisson equation (SPD), solved by PCG, once fully
+  matrix-free with the 5-point stencil applied on the grid, and
+  once on the assembled CSR matrix with each preconditioner,
+- a convection-diffusion equation (nonsymmetric), solved by
+  BiCGSTAB.
+*/
+
+// Function to apply the 5-point Laplacian on an n x n grid without a matrix
+void applyPoissonStencil(int n, const Eigen::VectorXd& u, Eigen::VectorXd& y) {
+    y.resize(u.size());
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            int i = r * n + c;
+            double value = 4.0 * u(i);
+            if (r > 0) value -= u(i - n);
+            if (r < n - 1) value -= u(i + n);
+            if (c > 0) value -= u(i - 1);
+            if (c < n - 1) value -= u(i + 1);
+            y(i) = value;
+        }
+    }
+}
+
+// Function to build the upwind convection-diffusion matrix -lap(u) + w . grad(u)
+// on an n x n grid; convection = 0 gives the 5-point Laplacian
+CSRMatrix buildConvectionDiffusionMatrix(int n, double convection) {
+    double h = 1.0 / (n + 1);
+    double wx = convection * h;  // Cell Peclet-number scaled upwind terms
+    double wy = 0.5 * convection * h;
+    std::vector<Eigen::Triplet<double>> entries;
+    entries.reserve(5 * static_cast<std::size_t>(n) * n);
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            int i = r * n + c;
+            entries.emplace_back(i, i, 4.0 + wx + wy);
+            if (r > 0) entries.emplace_back(i, i - n, -1.0 - wy);
+            if (r < n - 1) entries.emplace_back(i, i + n, -1.0);
+            if (c > 0) entries.emplace_back(i, i - 1, -1.0 - wx);
+            if (c < n - 1) entries.emplace_back(i, i + 1, -1.0);
+        }
+    }
+    CSRMatrix A(n * n, n * n);
+    A.setFromTriplets(entries.begin(), entries.end());
+    return A;
+}
+
+// Function to print one solver run
+void report(const std::string& name, const KrylovResult& result, double seconds) {
+    std::cout << name << ": " << result.iterations << " iterations, relative residual "
+              << result.relativeResidual << (result.converged ? "" : " (not converged)") << ", "
+              << seconds << " s" << std::endl;
+}
+
+int main() {
+    int n = 300;  // Grid points per side
+    Eigen::VectorXd b = Eigen::VectorXd::Ones(n * n);
+    KrylovOptions options;
+    options.maxIterations = 5000;
+    options.tolerance = 1e-8;
+
+    auto timed = [&](const std::string& name, auto solve) {
+        Eigen::VectorXd x = Eigen::VectorXd::Zero(n * n);
+        auto start = std::chrono::steady_clock::now();
+        KrylovResult result = solve(x);
+        report(name, result, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    };
+
+    // Matrix-free PCG: only the stencil and its diagonal are needed
+    LinearOperator stencil = [n](const Eigen::VectorXd& u, Eigen::VectorXd& y) { applyPoissonStencil(n, u, y); };
+    timed("PCG, matrix-free, Jacobi", [&](Eigen::VectorXd& x) {
+        return solvePCG(stencil, b, x, makeJacobiPreconditioner(Eigen::VectorXd::Constant(n * n, 4.0)), options);
+    });
+
+    // Assembled matrix with each preconditioner
+    CSRMatrix poisson = buildConvectionDiffusionMatrix(n, 0.0);
+    LinearOperator poissonOperator = makeMatrixOperator(poisson);
+    timed("PCG, no preconditioner", [&](Eigen::VectorXd& x) {
+        return solvePCG(poissonOperator, b, x, Preconditioner(), options);
+    });
+    timed("PCG, IC(0)", [&](Eigen::VectorXd& x) {
+        return solvePCG(poissonOperator, b, x, makeIncompleteLUPreconditioner(poisson), options);
+    });
+    timed("PCG, symmetric Gauss-Seidel", [&](Eigen::VectorXd& x) {
+        return solvePCG(poissonOperator, b, x, makeSymmetricGaussSeidelPreconditioner(poisson), options);
+    });
+
+    // Nonsymmetric convection-diffusion by BiCGSTAB
+    CSRMatrix convection = buildConvectionDiffusionMatrix(n, 200.0);
+    LinearOperator convectionOperator = makeMatrixOperator(convection);
+    timed("BiCGSTAB, Jacobi", [&](Eigen::VectorXd& x) {
+        return solveBiCGSTAB(convectionOperator, b, x, makeJacobiPreconditioner(convection), options);
+    });
+    timed("BiCGSTAB, ILU(0)", [&](Eigen::VectorXd& x) {
+        return solveBiCGSTAB(convectionOperator, b, x, makeIncompleteLUPreconditioner(convection), options);
+    });
+
+    // Check the last solve against the true residual
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(n * n);
+    solveBiCGSTAB(convectionOperator, b, x, makeIncompleteLUPreconditioner(convection), options);
+    std::cout << "True relative residual: " << (b - convection * x).norm() / b.norm() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,383 @@
+#ifndef KRYLOV_SOLVERS_H
+#define KRYLOV_SOLVERS_H
+
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include "GaussSeidelSolver.h"
+
+/*
+Krylov subspace solvers for large sparse systems Ax = b:
+
+- preconditioned conjugate gradient (PCG) for symmetric positive
+  definite A,
+- BiCGSTAB for general nonsymmetric A.
+
+Neither solver needs the matrix itself, only the product y = A x,
+which is passed in as a LinearOperator callback. Stencil codes can
+therefore apply the operator directly on the grid without ever
+building A. makeMatrixOperator wraps an assembled CSR matrix.
+
+A preconditioner is a callback z = M^-1 r with the same signature.
+The provided ones are
+
+- Jacobi (diagonal scaling), which needs only the diagonal and so
+  also works matrix-free,
+- ILU(0), the incomplete LU factorization keeping the sparsity
+  pattern of A. For symmetric A it is incomplete Cholesky IC(0) in
+  L D L^T form (U = D L^T), so it is valid for PCG as long as all
+  pivots stay positive,
+- symmetric Gauss-Seidel: one forward and one backward sweep from
+  zero, reusing the sweeps in GaussSeidelSolver.h.
+
+On large problems these solvers are limited by memory bandwidth,
+not arithmetic, so the vector updates of each iteration are fused
+and each vector is streamed once. PCG updates x and r and computes
+||r||^2 in one pass. BiCGSTAB finds both dot products for omega in
+one pass, and updates x and r together with the two dot products
+needed by the next iteration.
+
+The stopping test uses the recursively updated residual,
+||r|| <= tolerance * ||b||. In BiCGSTAB that residual can drift
+away from the true b - Ax when ||x|| is large, so before stopping
+BiCGSTAB recomputes the true residual and, if it is not yet small
+enough, restarts from it.
+*/
+
+// y = A x
+using LinearOperator = std::function<void(const Eigen::VectorXd& x, Eigen::VectorXd& y)>;
+
+// z = M^-1 r
+using Preconditioner = std::function<void(const Eigen::VectorXd& r, Eigen::VectorXd& z)>;
+
+struct KrylovOptions {
+    int maxIterations = 1000;
+    double tolerance = 1e-8;  // On ||r|| / ||b||
+};
+
+struct KrylovResult {
+    int iterations = 0;
+    double relativeResidual = -1.0;
+    bool converged = false;
+};
+
+// Function to wrap a CSR matrix as a linear operator (A must outlive it)
+inline LinearOperator makeMatrixOperator(const CSRMatrix& A) {
+    return [&A](const Eigen::VectorXd& x, Eigen::VectorXd& y) { y.noalias() = A * x; };
+}
+
+// Function to build the Jacobi preconditioner from the diagonal of A
+inline Preconditioner makeJacobiPreconditioner(const Eigen::VectorXd& diagonal) {
+    Eigen::VectorXd inverse = diagonal.cwiseInverse();
+    return [inverse](const Eigen::VectorXd& r, Eigen::VectorXd& z) { z = inverse.cwiseProduct(r); };
+}
+
+inline Preconditioner makeJacobiPreconditioner(const CSRMatrix& A) {
+    return makeJacobiPreconditioner(Eigen::VectorXd(A.diagonal()));
+}
+
+// Function to build the symmetric Gauss-Seidel preconditioner
+// M = (D + L) D^-1 (D + U) (A must outlive it)
+inline Preconditioner makeSymmetricGaussSeidelPreconditioner(const CSRMatrix& A) {
+    auto inverseDiagonal = std::make_shared<Eigen::VectorXd>();
+    if (!invertDiagonal(A, *inverseDiagonal)) {
+        return Preconditioner();
+    }
+    return [&A, inverseDiagonal](const Eigen::VectorXd& r, Eigen::VectorXd& z) {
+        z.setZero(r.size());
+        sorSweep(A, *inverseDiagonal, r, z, 1.0);
+        sorSweep(A, *inverseDiagonal, r, z, 1.0, true);
+    };
+}
+
+// Incomplete LU factorization with zero fill-in, stored in the pattern of A
+class IncompleteLU0 {
+public:
+    explicit IncompleteLU0(const CSRMatrix& A) : factors_(A) {
+        factors_.makeCompressed();
+        const int n = static_cast<int>(factors_.rows());
+        double* values = factors_.valuePtr();
+        const int* columns = factors_.innerIndexPtr();
+        const int* rowStart = factors_.outerIndexPtr();
+
+        diagonalPosition_.assign(n, -1);
+        std::vector<int> position(n, -1);  // Column -> index in the current row
+        for (int i = 0; i < n; ++i) {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                position[columns[k]] = k;
+            }
+            for (int k = rowStart[i]; k < rowStart[i + 1] && columns[k] < i; ++k) {
+                int row = columns[k];
+                values[k] /= values[diagonalPosition_[row]];
+                // Row i -= l(i, row) * U(row, :), restricted to the pattern of row i
+                for (int m = diagonalPosition_[row] + 1; m < rowStart[row + 1]; ++m) {
+                    int target = position[columns[m]];
+                    if (target >= 0) {
+                        values[target] -= values[k] * values[m];
+                    }
+                }
+            }
+            if (position[i] < 0 || values[position[i]] == 0.0) {
+                std::cerr << "ILU(0) breakdown: zero pivot in row " << i << std::endl;
+                ok_ = false;
+            }
+            diagonalPosition_[i] = position[i];
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                position[columns[k]] = -1;
+            }
+            if (!ok_) {
+                return;
+            }
+        }
+    }
+
+    bool ok() const { return ok_; }
+
+    // Function to solve L U z = r
+    void solve(const Eigen::VectorXd& r, Eigen::VectorXd& z) const {
+        const int n = static_cast<int>(factors_.rows());
+        const double* values = factors_.valuePtr();
+        const int* columns = factors_.innerIndexPtr();
+        const int* rowStart = factors_.outerIndexPtr();
+        z.resize(n);
+        for (int i = 0; i < n; ++i) {
+            double sum = r(i);
+            for (int k = rowStart[i]; k < diagonalPosition_[i]; ++k) {
+                sum -= values[k] * z(columns[k]);
+            }
+            z(i) = sum;
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            double sum = z(i);
+            for (int k = diagonalPosition_[i] + 1; k < rowStart[i + 1]; ++k) {
+                sum -= values[k] * z(columns[k]);
+            }
+            z(i) = sum / values[diagonalPosition_[i]];
+        }
+    }
+
+private:
+    CSRMatrix factors_;
+    std::vector<int> diagonalPosition_;
+    bool ok_ = true;
+};
+
+// Function to build the ILU(0) (IC(0) for symmetric A) preconditioner
+inline Preconditioner makeIncompleteLUPreconditioner(const CSRMatrix& A) {
+    auto factorization = std::make_shared<IncompleteLU0>(A);
+    if (!factorization->ok()) {
+        return Preconditioner();
+    }
+    return [factorization](const Eigen::VectorXd& r, Eigen::VectorXd& z) { factorization->solve(r, z); };
+}
+
+// Function to apply M^-1, or copy when there is no preconditioner
+inline void applyPreconditioner(const Preconditioner& M, const Eigen::VectorXd& r, Eigen::VectorXd& z) {
+    if (M) {
+        M(r, z);
+    } else {
+        z = r;
+    }
+}
+
+// Function to solve an SPD system by preconditioned conjugate gradient,
+// starting from and updating x
+inline KrylovResult solvePCG(const LinearOperator& A, const Eigen::VectorXd& b, Eigen::VectorXd& x,
+                             const Preconditioner& M = Preconditioner(),
+                             const KrylovOptions& options = KrylovOptions()) {
+    KrylovResult result;
+    const Eigen::Index n = b.size();
+    if (x.size() != n) {
+        x.setZero(n);
+    }
+    double bNorm = b.norm();
+    if (bNorm == 0.0) {
+        bNorm = 1.0;
+    }
+
+    Eigen::VectorXd r(n), z(n), p(n), q(n);
+    A(x, q);
+    r = b - q;
+    double rr = r.squaredNorm();
+    result.relativeResidual = std::sqrt(rr) / bNorm;
+    if (result.relativeResidual <= options.tolerance) {
+        result.converged = true;
+        return result;
+    }
+    applyPreconditioner(M, r, z);
+    p = z;
+    double rz = r.dot(z);
+
+    double* xData = x.data();
+    double* rData = r.data();
+    double* pData = p.data();
+    const double* qData = q.data();
+    while (result.iterations < options.maxIterations) {
+        A(p, q);
+        double pq = p.dot(q);
+        if (pq <= 0.0) {
+            std::cerr << "PCG breakdown: the operator is not positive definite." << std::endl;
+            break;
+        }
+        double alpha = rz / pq;
+
+        // Fused x += alpha p, r -= alpha q, rr = r.r
+        rr = 0.0;
+        for (Eigen::Index i = 0; i < n; ++i) {
+            xData[i] += alpha * pData[i];
+            rData[i] -= alpha * qData[i];
+            rr += rData[i] * rData[i];
+        }
+        ++result.iterations;
+        result.relativeResidual = std::sqrt(rr) / bNorm;
+        if (result.relativeResidual <= options.tolerance) {
+            result.converged = true;
+            break;
+        }
+
+        applyPreconditioner(M, r, z);
+        double rzNew = r.dot(z);
+        double beta = rzNew / rz;
+        rz = rzNew;
+        const double* zData = z.data();
+        for (Eigen::Index i = 0; i < n; ++i) {
+            pData[i] = zData[i] + beta * pData[i];
+        }
+    }
+    return result;
+}
+
+// Function to solve a general system by right-preconditioned BiCGSTAB,
+// starting from and updating x
+inline KrylovResult solveBiCGSTAB(const LinearOperator& A, const Eigen::VectorXd& b, Eigen::VectorXd& x,
+                                  const Preconditioner& M = Preconditioner(),
+                                  const KrylovOptions& options = KrylovOptions()) {
+    KrylovResult result;
+    const Eigen::Index n = b.size();
+    if (x.size() != n) {
+        x.setZero(n);
+    }
+    double bNorm = b.norm();
+    if (bNorm == 0.0) {
+        bNorm = 1.0;
+    }
+
+    Eigen::VectorXd r(n), shadow(n), p(n), v(n), s(n), t(n), pHat(n), sHat(n);
+    A(x, v);
+    r = b - v;
+    shadow = r;
+    double rho = r.squaredNorm();
+    result.relativeResidual = std::sqrt(rho) / bNorm;
+    if (result.relativeResidual <= options.tolerance) {
+        result.converged = true;
+        return result;
+    }
+    p = r;
+    v.setZero();
+    double alpha = 1.0;
+    double omega = 1.0;
+
+    // Function to accept convergence only if the true residual agrees,
+    // otherwise restart from the true residual
+    auto trueResidualConverged = [&]() {
+        A(x, v);
+        r = b - v;
+        rho = r.squaredNorm();
+        result.relativeResidual = std::sqrt(rho) / bNorm;
+        if (result.relativeResidual <= options.tolerance) {
+            return true;
+        }
+        shadow = r;
+        p = r;
+        return false;
+    };
+
+    double* xData = x.data();
+    double* rData = r.data();
+    double* pData = p.data();
+    double* sData = s.data();
+    const double* vData = v.data();
+    const double* tData = t.data();
+    const double* pHatData = pHat.data();
+    const double* sHatData = sHat.data();
+    const double* shadowData = shadow.data();
+    while (result.iterations < options.maxIterations) {
+        applyPreconditioner(M, p, pHat);
+        A(pHat, v);
+        double shadowV = shadow.dot(v);
+        if (shadowV == 0.0) {
+            std::cerr << "BiCGSTAB breakdown: r0 . v = 0" << std::endl;
+            break;
+        }
+        alpha = rho / shadowV;
+
+        // Fused s = r - alpha v, ss = s.s
+        double ss = 0.0;
+        for (Eigen::Index i = 0; i < n; ++i) {
+            sData[i] = rData[i] - alpha * vData[i];
+            ss += sData[i] * sData[i];
+        }
+        ++result.iterations;
+        if (std::sqrt(ss) / bNorm <= options.tolerance) {
+            x.noalias() += alpha * pHat;
+            if (trueResidualConverged()) {
+                result.converged = true;
+                break;
+            }
+            continue;
+        }
+
+        applyPreconditioner(M, s, sHat);
+        A(sHat, t);
+
+        // Fused t.s and t.t
+        double ts = 0.0;
+        double tt = 0.0;
+        for (Eigen::Index i = 0; i < n; ++i) {
+            ts += tData[i] * sData[i];
+            tt += tData[i] * tData[i];
+        }
+        if (tt == 0.0) {
+            std::cerr << "BiCGSTAB breakdown: t = 0" << std::endl;
+            break;
+        }
+        omega = ts / tt;
+
+        // Fused x += alpha pHat + omega sHat, r = s - omega t, rr = r.r, rho = r0.r
+        double rr = 0.0;
+        double rhoNew = 0.0;
+        for (Eigen::Index i = 0; i < n; ++i) {
+            xData[i] += alpha * pHatData[i] + omega * sHatData[i];
+            rData[i] = sData[i] - omega * tData[i];
+            rr += rData[i] * rData[i];
+            rhoNew += shadowData[i] * rData[i];
+        }
+        result.relativeResidual = std::sqrt(rr) / bNorm;
+        if (result.relativeResidual <= options.tolerance) {
+            if (trueResidualConverged()) {
+                result.converged = true;
+                break;
+            }
+            continue;
+        }
+        if (rhoNew == 0.0 || omega == 0.0) {
+            std::cerr << "BiCGSTAB breakdown: rho or omega = 0" << std::endl;
+            break;
+        }
+
+        // p = r + beta (p - omega v)
+        double beta = (rhoNew / rho) * (alpha / omega);
+        rho = rhoNew;
+        for (Eigen::Index i = 0; i < n; ++i) {
+            pData[i] = rData[i] + beta * (pData[i] - omega * vData[i]);
+        }
+    }
+    return result;
+}
+
+#endif
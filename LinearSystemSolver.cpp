@@ -1,6 +1,13 @@
 #include <iostream>
+#include <list>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <Eigen/Dense>
 
+#include "SmallSystemSolver.h"
+
 using namespace Eigen;
 
 /*
@@ -36,17 +43,156 @@ d data members specific to the Eigen library.
 */
 
 
+// Factorizations the solver can use: LU with partial pivoting for general
+// square matrices, column-pivoting Householder QR for ill-conditioned ones,
+// and Cholesky (LLT) for symmetric positive definite ones
+enum class Factorization { LU, QR, Cholesky };
+
+// Solver that factors A once and then solves any number of right-hand sides.
+// Singularity is judged from the factorization itself (the LU pivots, the QR
+// rank or the success of Cholesky), so no separate determinant is computed.
+class LinearSystemSolver {
+public:
+    LinearSystemSolver(const MatrixXd& A, Factorization method = Factorization::LU) : method_(method) {
+        if (A.rows() != A.cols() || A.rows() == 0) {
+            singular_ = true;
+            return;
+        }
+
+        switch (method_) {
+        case Factorization::QR:
+            qr_.compute(A);
+            singular_ = !qr_.isInvertible();
+            break;
+        case Factorization::Cholesky:
+            llt_.compute(A);
+            singular_ = llt_.info() != Success;
+            break;
+        default: {
+            lu_.compute(A);
+            // A pivot that is zero, or negligible next to the largest one, means A is singular
+            VectorXd pivots = lu_.matrixLU().diagonal().cwiseAbs();
+            double threshold = pivots.maxCoeff() * A.rows() * NumTraits<double>::epsilon();
+            singular_ = pivots.minCoeff() <= threshold;
+            break;
+        }
+        }
+    }
+
+    bool isSingular() const { return singular_; }
+    Factorization method() const { return method_; }
+
+    // Function to solve AX = B for one or more right-hand side columns
+    MatrixXd solve(const MatrixXd& B) const {
+        if (singular_) {
+            std::cerr << "Error: Matrix A is not invertible. Unable to solve the system." << std::endl;
+            return MatrixXd();
+        }
+
+        switch (method_) {
+        case Factorization::QR:
+            return qr_.solve(B);
+        case Factorization::Cholesky:
+            return llt_.solve(B);
+        default:
+            return lu_.solve(B);
+        }
+    }
+
+    // Function to solve Ax = b for a single right-hand side
+    VectorXd solve(const VectorXd& b) const {
+        MatrixXd x = solve(MatrixXd(b));
+        return x.size() == 0 ? VectorXd() : VectorXd(x.col(0));
+    }
+
+private:
+    Factorization method_;
+    bool singular_ = false;
+    PartialPivLU<MatrixXd> lu_;
+    ColPivHouseholderQR<MatrixXd> qr_;
+    LLT<MatrixXd> llt_;
+};
+
+// Least-recently-used cache of factorizations keyed by matrix content, for
+// workloads that solve with the same system matrix again and again. Entries
+// are matched on a hash of the matrix and then compared exactly.
+class FactorizationCache {
+public:
+    explicit FactorizationCache(std::size_t capacity) : capacity_(capacity) {}
+
+    // Function to return the solver for A, factoring it only on a cache miss
+    std::shared_ptr<const LinearSystemSolver> get(const MatrixXd& A, Factorization method = Factorization::LU) {
+        std::size_t key = hashMatrix(A, method);
+        auto range = index_.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            const Entry& entry = *it->second;
+            if (entry.method == method && entry.matrix.rows() == A.rows() && entry.matrix.cols() == A.cols() &&
+                entry.matrix == A) {
+                // Move the hit to the front of the recency list
+                entries_.splice(entries_.begin(), entries_, it->second);
+                ++hits_;
+                return entry.solver;
+            }
+        }
+
+        ++misses_;
+        auto solver = std::make_shared<const LinearSystemSolver>(A, method);
+        entries_.push_front(Entry{key, method, A, solver});
+        index_.emplace(key, entries_.begin());
+        // With capacity 0 this evicts the new entry at once, so nothing is cached
+        if (entries_.size() > capacity_) {
+            evictLeastRecent();
+        }
+        return solver;
+    }
+
+    std::size_t size() const { return entries_.size(); }
+    std::size_t hits() const { return hits_; }
+    std::size_t misses() const { return misses_; }
+
+private:
+    struct Entry {
+        std::size_t key;
+        Factorization method;
+        MatrixXd matrix;
+        std::shared_ptr<const LinearSystemSolver> solver;
+    };
+
+    // Function to hash the dimensions, entries and factorization method
+    static std::size_t hashMatrix(const MatrixXd& A, Factorization method) {
+        std::string_view bytes(reinterpret_cast<const char*>(A.data()), A.size() * sizeof(double));
+        std::size_t seed = std::hash<std::string_view>{}(bytes);
+        for (std::size_t value : {static_cast<std::size_t>(A.rows()), static_cast<std::size_t>(A.cols()),
+                                  static_cast<std::size_t>(method)}) {
+            seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+
+    void evictLeastRecent() {
+        auto last = std::prev(entries_.end());
+        auto range = index_.equal_range(last->key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == last) {
+                index_.erase(it);
+                break;
+            }
+        }
+        entries_.pop_back();
+    }
+
+    std::size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_multimap<std::size_t, std::list<Entry>::iterator> index_;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+};
+
 // Function to solve the system of linear equations Ax = b
 VectorXd solveLinearSystem(const MatrixXd& A, const VectorXd& b) {
-    // Check if the matrix A is invertible
-    if (A.determinant() == 0) {
-        std::cerr << "Error: Matrix A is not invertible. Unable to solve the system." << std::endl;
-        return VectorXd();
-    }
-    
-    // Solve the linear system Ax = b using LU decomposition
-    VectorXd x = A.lu().solve(b);
-    return x;
+    // Factor A once; the LU pivots also tell whether A is invertible
+    LinearSystemSolver solver(A, Factorization::LU);
+    return solver.solve(b);
 }
 
 int main() {
@@ -86,5 +232,34 @@ int main() {
     // Print the solution
     std::cout << "Solution: x = \n" << x2 << std::endl; 
 
+    // Factor B once and solve several right-hand sides in one batch
+    LinearSystemSolver solver(B, Factorization::QR);
+    MatrixXd rhs(4, 2);
+    rhs.col(0) = b2;
+    rhs.col(1) = B * VectorXd::Ones(4);
+    std::cout << "Batched solutions (one per column): \n" << solver.solve(rhs) << std::endl;
+
+    // Repeated systems are factored only once through the cache
+    FactorizationCache cache(8);
+    for (int k = 0; k < 3; ++k) {
+        cache.get(A)->solve(b);
+    }
+    std::cout << "Cache hits: " << cache.hits() << ", misses: " << cache.misses() << std::endl;
+
+    // Many small systems of the same size are solved together, a few at a time per SIMD lane
+    const std::size_t count = 1000;
+    std::vector<double> As(9 * count), bs(3 * count), xs(3 * count);
+    std::vector<unsigned char> singular(count);
+    for (std::size_t s = 0; s < count; ++s) {
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                As[(i * 3 + j) * count + s] = A(i, j) + (i == j ? 0.001 * s : 0.0);
+            }
+            bs[i * count + s] = b(i);
+        }
+    }
+    solveSmallSystems<3>(As.data(), bs.data(), xs.data(), singular.data(), count);
+    std::cout << "First batched 3x3 solution: " << xs[0] << " " << xs[count] << " " << xs[2 * count] << std::endl;
+
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <Eigen/Dense>
+
+#include "KrylovSolvers.h"
+#include "MultigridSolver.h"
+
+/*
+Demonstration of the geometric multigrid in MultigridSolver.h on
+the Poisson equation -lap(u) = 1 on the unit square and cube.
+
+For every grid it reports the number of V-cycles, W-cycles and
+multigrid-preconditioned CG iterations needed to reduce the
+residual by 1e-8. The counts stay roughly constant as the grid is
+refined, whereas CG with Jacobi alone (shown for the 2D grids)
+needs about twice as many iterations each time the side doubles.
+
+An optional argument sets the side of the largest 3D grid; 255
+gives 255^3 = 16.6 million unknowns.
+*/
+
+// Function to run the solvers on one grid and print the iteration counts
+void runGrid(int n, int dimensions, bool withCG) {
+    int nz = dimensions == 3 ? n : 1;
+    double h = 1.0 / (n + 1);
+    long long size = static_cast<long long>(n) * n * nz;
+    Eigen::VectorXd f = Eigen::VectorXd::Ones(size);
+
+    auto elapsed = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::cout << dimensions << "D, " << n << "^" << dimensions << " = " << size << " unknowns:";
+
+    for (MultigridCycle cycle : {MultigridCycle::V, MultigridCycle::W}) {
+        MultigridOptions options;
+        options.cycle = cycle;
+        MultigridSolver multigrid(n, n, nz, h, StencilCoefficients(), options);
+        Eigen::VectorXd u = Eigen::VectorXd::Zero(size);
+        auto start = std::chrono::steady_clock::now();
+        KrylovResult result = multigrid.solve(f, u);
+        std::cout << "  " << (cycle == MultigridCycle::V ? "V" : "W") << "-cycles " << result.iterations
+                  << " (" << elapsed(start) << " s)";
+    }
+
+    MultigridSolver multigrid(n, n, nz, h);
+    KrylovOptions krylov;
+    krylov.maxIterations = 10000;
+    Eigen::VectorXd u = Eigen::VectorXd::Zero(size);
+    auto start = std::chrono::steady_clock::now();
+    KrylovResult result = solvePCG(multigrid.linearOperator(), f, u, multigrid.preconditioner(), krylov);
+    std::cout << "  MG-PCG " << result.iterations << " (" << elapsed(start) << " s)";
+
+    if (withCG) {
+        double diagonal = dimensions == 3 ? 6.0 / (h * h) : 4.0 / (h * h);
+        u.setZero();
+        start = std::chrono::steady_clock::now();
+        result = solvePCG(multigrid.linearOperator(), f, u,
+                          makeJacobiPreconditioner(Eigen::VectorXd::Constant(size, diagonal)), krylov);
+        std::cout << "  Jacobi-PCG " << result.iterations << " (" << elapsed(start) << " s)";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int largest3D = 127;
+    if (argc >= 2) {
+        largest3D = std::atoi(argv[1]);
+    }
+
+    for (int n : {63, 127, 255, 511, 1023}) {
+        runGrid(n, 2, true);
+    }
+    for (int n = 15; n <= largest3D; n = 2 * n + 1) {
+        runGrid(n, 3, false);
+    }
+
+    return 0;
+}
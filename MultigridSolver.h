@@ -0,0 +1,363 @@
+#ifndef MULTIGRID_SOLVER_H
+#define MULTIGRID_SOLVER_H
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include "KrylovSolvers.h"
+
+/*
+Geometric multigrid for Poisson-like equations on regular 2D and
+3D grids,
+
+    -(ax u_xx + ay u_yy + az u_zz) + shift u = f,
+
+with u = 0 on the boundary, discretized by the 5-point (2D) or
+7-point (3D) stencil on nx x ny x nz interior points with spacing
+h (nz = 1 for 2D).
+
+Single-level methods such as Gauss-Seidel or plain CG need more
+iterations as the grid is refined. Gauss-Seidel removes the
+oscillatory part of the error quickly but the smooth part only
+slowly. Multigrid smooths on the fine grid and moves the rest of
+the error to a grid with half the points per side, where it is
+oscillatory again, and so on recursively. The number of cycles
+then hardly depends on the grid size.
+
+Every level applies the operator straight from the stencil; no
+matrix is assembled except on the coarsest grid, which is factored
+once by sparse Cholesky. Grids coarsen from n to (n - 1) / 2
+points per side while every non-flat side is odd and at least 3,
+so sides of 2^k - 1 points coarsen all the way down.
+
+- Smoother: red-black Gauss-Seidel, in place. Red before black
+  when pre-smoothing and black before red when post-smoothing, so
+  the cycle is symmetric.
+- Prolongation: bilinear (2D) or trilinear (3D) interpolation.
+- Restriction: full weighting, the transpose of the prolongation
+  scaled by 2^-dim.
+- Cycle: V (one coarse visit per level) or W (two).
+
+Because the cycle is symmetric, one cycle from a zero guess is an
+SPD preconditioner, and preconditioner() hands it to solvePCG.
+solve() iterates cycles on their own.
+*/
+
+enum class MultigridCycle {V, W};
+
+// Coefficients of -(ax u_xx + ay u_yy + az u_zz) + shift u
+struct StencilCoefficients {
+    double ax = 1.0;
+    double ay = 1.0;
+    double az = 1.0;
+    double shift = 0.0;
+};
+
+struct MultigridOptions {
+    MultigridCycle cycle = MultigridCycle::V;
+    int preSmoothing = 2;
+    int postSmoothing = 2;
+    int maxCycles = 100;
+    double tolerance = 1e-8;  // On ||f - Au|| / ||f|| for solve()
+};
+
+class MultigridSolver {
+public:
+    MultigridSolver(int nx, int ny, int nz, double h, const StencilCoefficients& coefficients = StencilCoefficients(),
+                    const MultigridOptions& options = MultigridOptions())
+        : coefficients_(coefficients), options_(options) {
+        // Sides of one point are flat (nz = 1 for 2D) and never coarsened
+        flat_[0] = nx == 1;
+        flat_[1] = ny == 1;
+        flat_[2] = nz == 1;
+        levels_.emplace_back(nx, ny, nz, h);
+        while (canCoarsen(levels_.back())) {
+            const Level& level = levels_.back();
+            levels_.emplace_back(coarsenSide(level.nx, flat_[0]), coarsenSide(level.ny, flat_[1]),
+                                 coarsenSide(level.nz, flat_[2]), 2.0 * level.h);
+        }
+        factorCoarsestLevel();
+    }
+
+    int numLevels() const { return static_cast<int>(levels_.size()); }
+    long long size() const { return levels_[0].size(); }
+    bool ok() const { return coarseSolver_.info() == Eigen::Success; }
+
+    // Function to apply the fine-grid operator y = A u
+    void apply(const Eigen::VectorXd& u, Eigen::VectorXd& y) const {
+        y.resize(u.size());
+        applyOperator(levels_[0], u, y);
+    }
+
+    // The fine-grid operator as a callback for the Krylov solvers
+    LinearOperator linearOperator() const {
+        return [this](const Eigen::VectorXd& u, Eigen::VectorXd& y) { apply(u, y); };
+    }
+
+    // One multigrid cycle from a zero guess, as a preconditioner for solvePCG
+    Preconditioner preconditioner() {
+        return [this](const Eigen::VectorXd& r, Eigen::VectorXd& z) {
+            z.setZero(r.size());
+            cycle(0, r, z);
+        };
+    }
+
+    // Function to perform one cycle on Au = f, improving u in place
+    void cycle(const Eigen::VectorXd& f, Eigen::VectorXd& u) {
+        if (u.size() != f.size()) {
+            u.setZero(f.size());
+        }
+        cycle(0, f, u);
+    }
+
+    // Function to solve Au = f by repeated cycles, starting from and updating u
+    KrylovResult solve(const Eigen::VectorXd& f, Eigen::VectorXd& u) {
+        KrylovResult result;
+        if (u.size() != f.size()) {
+            u.setZero(f.size());
+        }
+        double fNorm = f.norm();
+        if (fNorm == 0.0) {
+            fNorm = 1.0;
+        }
+        Level& fine = levels_[0];
+        while (result.iterations < options_.maxCycles) {
+            cycle(0, f, u);
+            ++result.iterations;
+            residual(fine, f, u, fine.r);
+            result.relativeResidual = fine.r.norm() / fNorm;
+            if (result.relativeResidual <= options_.tolerance) {
+                result.converged = true;
+                break;
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Level {
+        int nx, ny, nz;
+        double h;
+        Eigen::VectorXd f, u, r;  // Right-hand side, iterate and residual storage
+
+        Level(int sizeX, int sizeY, int sizeZ, double spacing) : nx(sizeX), ny(sizeY), nz(sizeZ), h(spacing) {
+            f.setZero(size());
+            u.setZero(size());
+            r.setZero(size());
+        }
+
+        long long size() const { return static_cast<long long>(nx) * ny * nz; }
+    };
+
+    static bool coarsenable(int n, bool flat) { return flat || (n >= 3 && n % 2 == 1); }
+    static int coarsenSide(int n, bool flat) { return flat ? 1 : (n - 1) / 2; }
+
+    bool canCoarsen(const Level& level) const {
+        bool anySide = !flat_[0] || !flat_[1] || !flat_[2];
+        return anySide && coarsenable(level.nx, flat_[0]) && coarsenable(level.ny, flat_[1]) &&
+               coarsenable(level.nz, flat_[2]);
+    }
+
+    // Stencil weights of one level: off-diagonals per axis and the diagonal
+    void stencil(const Level& level, double& cx, double& cy, double& cz, double& diagonal) const {
+        double scale = 1.0 / (level.h * level.h);
+        cx = flat_[0] ? 0.0 : coefficients_.ax * scale;
+        cy = flat_[1] ? 0.0 : coefficients_.ay * scale;
+        cz = flat_[2] ? 0.0 : coefficients_.az * scale;
+        diagonal = 2.0 * (cx + cy + cz) + coefficients_.shift;
+    }
+
+    // Function to compute the weighted neighbour sum of point (i, j, k), zero outside the grid
+    static double neighbourSum(const Level& level, const double* u, long long index, int i, int j, int k,
+                               double cx, double cy, double cz) {
+        const long long strideY = level.nx;
+        const long long strideZ = static_cast<long long>(level.nx) * level.ny;
+        double sum = 0.0;
+        if (i > 0) sum += cx * u[index - 1];
+        if (i < level.nx - 1) sum += cx * u[index + 1];
+        if (j > 0) sum += cy * u[index - strideY];
+        if (j < level.ny - 1) sum += cy * u[index + strideY];
+        if (k > 0) sum += cz * u[index - strideZ];
+        if (k < level.nz - 1) sum += cz * u[index + strideZ];
+        return sum;
+    }
+
+    void applyOperator(const Level& level, const Eigen::VectorXd& u, Eigen::VectorXd& y) const {
+        double cx, cy, cz, diagonal;
+        stencil(level, cx, cy, cz, diagonal);
+        const double* uData = u.data();
+        long long index = 0;
+        for (int k = 0; k < level.nz; ++k) {
+            for (int j = 0; j < level.ny; ++j) {
+                for (int i = 0; i < level.nx; ++i, ++index) {
+                    y(index) = diagonal * uData[index] - neighbourSum(level, uData, index, i, j, k, cx, cy, cz);
+                }
+            }
+        }
+    }
+
+    void residual(const Level& level, const Eigen::VectorXd& f, const Eigen::VectorXd& u, Eigen::VectorXd& r) const {
+        applyOperator(level, u, r);
+        r = f - r;
+    }
+
+    // Function to update every point of one colour ((i + j + k) % 2 == color) in place
+    void smoothColor(const Level& level, const Eigen::VectorXd& f, Eigen::VectorXd& u, int color) const {
+        double cx, cy, cz, diagonal;
+        stencil(level, cx, cy, cz, diagonal);
+        double inverseDiagonal = 1.0 / diagonal;
+        double* uData = u.data();
+        for (int k = 0; k < level.nz; ++k) {
+            for (int j = 0; j < level.ny; ++j) {
+                long long rowStart = (static_cast<long long>(k) * level.ny + j) * level.nx;
+                for (int i = (color + j + k) & 1; i < level.nx; i += 2) {
+                    long long index = rowStart + i;
+                    uData[index] = (f(index) + neighbourSum(level, uData, index, i, j, k, cx, cy, cz)) * inverseDiagonal;
+                }
+            }
+        }
+    }
+
+    void smooth(const Level& level, const Eigen::VectorXd& f, Eigen::VectorXd& u, int sweeps, bool redFirst) const {
+        for (int s = 0; s < sweeps; ++s) {
+            smoothColor(level, f, u, redFirst ? 0 : 1);
+            smoothColor(level, f, u, redFirst ? 1 : 0);
+        }
+    }
+
+    // Interpolation weights along one axis: fine point i takes weight from
+    // up to two coarse points (count, coarse indices, weights)
+    static int axisWeights(int fineSize, bool flat, int i, int coarse[2], double weight[2]) {
+        if (flat) {
+            coarse[0] = 0;
+            weight[0] = 1.0;
+            return 1;
+        }
+        if (i % 2 == 1) {
+            coarse[0] = (i - 1) / 2;
+            weight[0] = 1.0;
+            return 1;
+        }
+        int count = 0;
+        int coarseSize = coarsenSide(fineSize, false);
+        if (i / 2 - 1 >= 0) {
+            coarse[count] = i / 2 - 1;
+            weight[count++] = 0.5;
+        }
+        if (i / 2 < coarseSize) {
+            coarse[count] = i / 2;
+            weight[count++] = 0.5;
+        }
+        return count;
+    }
+
+    // Function to visit each (fine point, coarse point, weight) of the prolongation
+    template <typename Visit>
+    void forEachTransfer(const Level& fine, const Level& coarse, Visit visit) const {
+        int ci[2], cj[2], ck[2];
+        double wi[2], wj[2], wk[2];
+        long long index = 0;
+        for (int k = 0; k < fine.nz; ++k) {
+            int nk = axisWeights(fine.nz, flat_[2], k, ck, wk);
+            for (int j = 0; j < fine.ny; ++j) {
+                int nj = axisWeights(fine.ny, flat_[1], j, cj, wj);
+                for (int i = 0; i < fine.nx; ++i, ++index) {
+                    int ni = axisWeights(fine.nx, flat_[0], i, ci, wi);
+                    for (int c = 0; c < nk; ++c) {
+                        for (int b = 0; b < nj; ++b) {
+                            long long coarseRow = (static_cast<long long>(ck[c]) * coarse.ny + cj[b]) * coarse.nx;
+                            for (int a = 0; a < ni; ++a) {
+                                visit(index, coarseRow + ci[a], wk[c] * wj[b] * wi[a]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Full weighting: coarse = 2^-dim P^T fine
+    void restrictToCoarse(const Level& fine, const Level& coarse, const Eigen::VectorXd& r, Eigen::VectorXd& f) const {
+        int dimensions = !flat_[0] + !flat_[1] + !flat_[2];
+        double scale = 1.0 / (1 << dimensions);
+        f.setZero();
+        forEachTransfer(fine, coarse, [&](long long fineIndex, long long coarseIndex, double weight) {
+            f(coarseIndex) += scale * weight * r(fineIndex);
+        });
+    }
+
+    // Interpolation: fine += P coarse
+    void prolongAndAdd(const Level& fine, const Level& coarse, const Eigen::VectorXd& e, Eigen::VectorXd& u) const {
+        forEachTransfer(fine, coarse, [&](long long fineIndex, long long coarseIndex, double weight) {
+            u(fineIndex) += weight * e(coarseIndex);
+        });
+    }
+
+    // Function to assemble and factor the coarsest operator
+    void factorCoarsestLevel() {
+        const Level& level = levels_.back();
+        double cx, cy, cz, diagonal;
+        stencil(level, cx, cy, cz, diagonal);
+        std::vector<Eigen::Triplet<double>> entries;
+        long long index = 0;
+        const long long strideY = level.nx;
+        const long long strideZ = static_cast<long long>(level.nx) * level.ny;
+        for (int k = 0; k < level.nz; ++k) {
+            for (int j = 0; j < level.ny; ++j) {
+                for (int i = 0; i < level.nx; ++i, ++index) {
+                    entries.emplace_back(index, index, diagonal);
+                    if (i > 0) entries.emplace_back(index, index - 1, -cx);
+                    if (i < level.nx - 1) entries.emplace_back(index, index + 1, -cx);
+                    if (j > 0) entries.emplace_back(index, index - strideY, -cy);
+                    if (j < level.ny - 1) entries.emplace_back(index, index + strideY, -cy);
+                    if (k > 0) entries.emplace_back(index, index - strideZ, -cz);
+                    if (k < level.nz - 1) entries.emplace_back(index, index + strideZ, -cz);
+                }
+            }
+        }
+        Eigen::SparseMatrix<double> A(level.size(), level.size());
+        A.setFromTriplets(entries.begin(), entries.end());
+        coarseSolver_.compute(A);
+        if (coarseSolver_.info() != Eigen::Success) {
+            std::cerr << "Multigrid: the coarsest operator is not positive definite." << std::endl;
+        }
+        if (level.size() > 100000) {
+            std::cerr << "Multigrid: the grid coarsens only to " << level.nx << " x " << level.ny << " x "
+                      << level.nz << "; use sides of 2^k - 1 points." << std::endl;
+        }
+    }
+
+    void cycle(int index, const Eigen::VectorXd& f, Eigen::VectorXd& u) {
+        Level& level = levels_[index];
+        if (index == numLevels() - 1) {
+            u = coarseSolver_.solve(f);
+            return;
+        }
+        Level& coarse = levels_[index + 1];
+
+        smooth(level, f, u, options_.preSmoothing, true);
+        residual(level, f, u, level.r);
+        restrictToCoarse(level, coarse, level.r, coarse.f);
+
+        coarse.u.setZero();
+        int visits = (options_.cycle == MultigridCycle::W && index + 2 < numLevels()) ? 2 : 1;
+        for (int v = 0; v < visits; ++v) {
+            cycle(index + 1, coarse.f, coarse.u);
+        }
+
+        prolongAndAdd(level, coarse, coarse.u, u);
+        smooth(level, f, u, options_.postSmoothing, false);
+    }
+
+    StencilCoefficients coefficients_;
+    MultigridOptions options_;
+    bool flat_[3];
+    std::vector<Level> levels_;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> coarseSolver_;
+};
+
+#endif
@@ -1,6 +1,17 @@
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 #include <Eigen/Dense>
 
+#include "SignalIO.h"
+
 using namespace Eigen;
 
 /*
@@ -18,7 +29,239 @@ The evaluation of the fitting performance is also inclu
 ded, using the mean squared error (MSE). 
 */
 
-int main() {
+/*
+Streaming regression for data sets far larger than memory
+(hundreds of millions of rows, a few dozen features).
+
+Rather than building the design matrix A, rows are read in chunks
+and only the normal equations are kept. They are stored as one
+augmented (p + 1) x (p + 1) matrix, where p is the number of
+features:
+
+    [A b]^T [A b] = [ A^T A   A^T b ]
+                    [ b^T A   b^T b ]
+
+Each chunk C = [A_k b_k] adds C^T C to its lower triangle through
+a symmetric rank-k update (SYRK, Eigen's rankUpdate), a single
+cache-friendly pass that yields A^T A, A^T b and b^T b together.
+Memory is O(p^2) whatever the number of rows.
+
+Chunks can come from a callback, a text file with one row per
+line (features first, target last), or a binary signal file with
+p + 1 channels (see SignalIO.h). With several threads every thread
+accumulates its own partial sums, and these are added at the end.
+The coefficients are then found with the LLT (Cholesky) solve used
+in main, and the MSE comes from the same sums:
+
+    SSE = b^T b - 2 x^T A^T b + x^T A^T A x
+*/
+
+class NormalEquationsAccumulator {
+public:
+    explicit NormalEquationsAccumulator(int numFeatures)
+        : numFeatures_(numFeatures), gram_(MatrixXd::Zero(numFeatures + 1, numFeatures + 1)) {}
+
+    int numFeatures() const { return numFeatures_; }
+    long long numRows() const { return numRows_; }
+
+    // Function to add numRows rows stored row-major as [features..., target]
+    void addRows(const double* rows, std::size_t numRows) {
+        if (numRows == 0) {
+            return;
+        }
+        Map<const Matrix<double, Dynamic, Dynamic, RowMajor>> chunk(rows, numRows, numFeatures_ + 1);
+        gram_.selfadjointView<Lower>().rankUpdate(chunk.transpose());
+        numRows_ += static_cast<long long>(numRows);
+    }
+
+    // Function to add the partial sums of another accumulator
+    void merge(const NormalEquationsAccumulator& other) {
+        gram_ += other.gram_;
+        numRows_ += other.numRows_;
+    }
+
+    MatrixXd ATA() const {
+        return gram_.topLeftCorner(numFeatures_, numFeatures_).selfadjointView<Lower>();
+    }
+
+    VectorXd ATb() const { return gram_.row(numFeatures_).head(numFeatures_).transpose(); }
+
+    double bTb() const { return gram_(numFeatures_, numFeatures_); }
+
+    // Function to solve A^T A x = A^T b by Cholesky decomposition
+    bool solve(VectorXd& x) const {
+        LLT<MatrixXd> llt(ATA());
+        if (llt.info() != Success) {
+            std::cout << "Cholesky decomposition failed!" << std::endl;
+            return false;
+        }
+        x = llt.solve(ATb());
+        return true;
+    }
+
+    // Function to compute the mean squared error of x from the accumulated sums
+    double meanSquaredError(const VectorXd& x) const {
+        if (numRows_ == 0) {
+            return 0.0;
+        }
+        double sse = bTb() - 2.0 * x.dot(ATb()) + x.dot(ATA() * x);
+        return std::max(sse, 0.0) / numRows_;
+    }
+
+private:
+    int numFeatures_;
+    MatrixXd gram_;  // Lower triangle of [A b]^T [A b]
+    long long numRows_ = 0;
+};
+
+// Fills up to maxRows rows ([features..., target], row-major) and returns
+// how many were filled; 0 marks the end of the data
+using RegressionRowSource = std::function<std::size_t(double* rows, std::size_t maxRows)>;
+
+// Function to accumulate every row of a source, with per-thread partial sums.
+// The source is called under a lock, so it need not be thread-safe.
+void accumulateRows(const RegressionRowSource& source, NormalEquationsAccumulator& total, int numThreads,
+                    std::size_t chunkRows = 4096) {
+    std::mutex sourceMutex;
+    std::vector<NormalEquationsAccumulator> partial(numThreads, NormalEquationsAccumulator(total.numFeatures()));
+    auto worker = [&](int t) {
+        std::vector<double> chunk(chunkRows * (total.numFeatures() + 1));
+        while (true) {
+            std::size_t filled;
+            {
+                std::lock_guard<std::mutex> lock(sourceMutex);
+                filled = source(chunk.data(), chunkRows);
+            }
+            if (filled == 0) {
+                break;
+            }
+            partial[t].addRows(chunk.data(), filled);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& sums : partial) {
+        total.merge(sums);
+    }
+}
+
+// Function to accumulate a text file with one row per line. Each thread parses
+// its own byte range of the mapped file, split at line boundaries.
+bool accumulateTextFile(const std::string& filename, NormalEquationsAccumulator& total, int numThreads,
+                        std::size_t chunkRows = 4096) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Failed to open the file: " << filename << std::endl;
+        return false;
+    }
+
+    const std::size_t numColumns = total.numFeatures() + 1;
+    std::vector<std::size_t> boundaries(numThreads + 1, file.size());
+    boundaries[0] = 0;
+    for (int t = 1; t < numThreads; ++t) {
+        std::size_t position = std::max(boundaries[t - 1], file.size() * t / numThreads);
+        const void* newline = position < file.size()
+                                  ? std::memchr(file.data() + position, '\n', file.size() - position) : nullptr;
+        boundaries[t] = newline ? static_cast<const char*>(newline) - file.data() + 1 : file.size();
+    }
+
+    std::vector<NormalEquationsAccumulator> partial(numThreads, NormalEquationsAccumulator(total.numFeatures()));
+    std::vector<std::vector<SignalParseError>> errors(numThreads);
+    std::vector<std::size_t> badRowLine(numThreads, 0);
+
+    auto worker = [&](int t) {
+        std::vector<double> chunk;
+        chunk.reserve(chunkRows * numColumns);
+        std::size_t rowBegin = 0;
+        parseSignalText(file.data() + boundaries[t], boundaries[t + 1] - boundaries[t],
+                        [&](double value) { chunk.push_back(value); },
+                        [&](std::size_t numCells, std::size_t lineNumber) {
+                            if (numCells != numColumns) {
+                                if (badRowLine[t] == 0) {
+                                    badRowLine[t] = lineNumber;
+                                }
+                                chunk.resize(rowBegin);  // Drop the row
+                            }
+                            rowBegin = chunk.size();
+                            if (chunk.size() == chunkRows * numColumns) {
+                                partial[t].addRows(chunk.data(), chunkRows);
+                                chunk.clear();
+                                rowBegin = 0;
+                            }
+                        },
+                        errors[t]);
+        partial[t].addRows(chunk.data(), chunk.size() / numColumns);
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool ok = true;
+    for (int t = 0; t < numThreads; ++t) {
+        ok = ok && errors[t].empty() && badRowLine[t] == 0;
+    }
+    if (!ok) {
+        // Line numbers are relative to each thread's range; shift them to file lines
+        std::size_t lineOffset = 0;
+        for (int t = 0; t < numThreads; ++t) {
+            for (auto& error : errors[t]) {
+                error.line += lineOffset;
+            }
+            reportSignalParseErrors(filename, errors[t]);
+            if (badRowLine[t] != 0) {
+                std::cerr << "Expected " << numColumns << " columns on line " << badRowLine[t] + lineOffset
+                          << " of " << filename << std::endl;
+            }
+            lineOffset += std::count(file.data() + boundaries[t], file.data() + boundaries[t + 1], '\n');
+        }
+        return false;
+    }
+    for (const auto& sums : partial) {
+        total.merge(sums);
+    }
+    return true;
+}
+
+// Function to accumulate a text or binary (p + 1 channel) regression file
+bool accumulateRegressionFile(const std::string& filename, NormalEquationsAccumulator& total, int numThreads) {
+    if (!isBinarySignalFile(filename)) {
+        return accumulateTextFile(filename, total, numThreads);
+    }
+
+    BinarySignalFile file(filename);
+    if (!file.isOpen()) {
+        return false;
+    }
+    const std::size_t numColumns = total.numFeatures() + 1;
+    if (file.header().numChannels != numColumns) {
+        std::cerr << "Expected " << numColumns << " channels in " << filename << std::endl;
+        return false;
+    }
+    std::size_t nextRow = 0;
+    std::size_t numRows = file.header().numSamples;
+    accumulateRows([&](double* rows, std::size_t maxRows) {
+        std::size_t count = std::min(maxRows, numRows - nextRow);
+        file.copySamples(nextRow * numColumns, count * numColumns, rows);
+        nextRow += count;
+        return count;
+    }, total, numThreads);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
     // Define the observed data points
     VectorXd b(5);
     b << 10.1, 10.2, 10.0, 10.1, 10.0; 
@@ -56,5 +299,65 @@ int main() {
     std::cout << x << std::endl;
     std::cout << "Mean Squared Error (MSE): " << mse << std::endl;
 
+    // The same fit streamed row by row through the normal-equations accumulator
+    NormalEquationsAccumulator small(4);
+    for (int i = 0; i < A.rows(); ++i) {
+        double row[5] = {A(i, 0), A(i, 1), A(i, 2), A(i, 3), b(i)};
+        small.addRows(row, 1);
+    }
+    VectorXd xStreamed;
+    if (small.solve(xStreamed)) {
+        std::cout << "Streamed fit differs by " << (xStreamed - x).norm() << ", MSE "
+                  << small.meanSquaredError(xStreamed) << std::endl;
+    }
+
+    int numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // A regression file given on the command line: numFeatures followed by the file
+    if (argc >= 3) {
+        NormalEquationsAccumulator fromFile(std::stoi(argv[1]));
+        VectorXd coefficients;
+        if (!accumulateRegressionFile(argv[2], fromFile, numThreads) || !fromFile.solve(coefficients)) {
+            return 1;
+        }
+        std::cout << fromFile.numRows() << " rows, coefficients:\n" << coefficients << "\nMSE: "
+                  << fromFile.meanSquaredError(coefficients) << std::endl;
+        return 0;
+    }
+
+    // Rows generated on the fly by a callback: y = sum_j (j + 1) x_j + noise
+    const int numFeatures = 24;
+    const std::size_t totalRows = 2000000;
+    std::size_t generated = 0;
+    std::mt19937_64 generator(42);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    RegressionRowSource source = [&](double* rows, std::size_t maxRows) {
+        std::size_t count = std::min(maxRows, totalRows - generated);
+        for (std::size_t i = 0; i < count; ++i) {
+            double* row = rows + i * (numFeatures + 1);
+            double y = 0.0;
+            for (int j = 0; j < numFeatures; ++j) {
+                row[j] = normal(generator);
+                y += (j + 1) * row[j];
+            }
+            row[numFeatures] = y + 0.1 * normal(generator);
+        }
+        generated += count;
+        return count;
+    };
+
+    NormalEquationsAccumulator large(numFeatures);
+    auto start = std::chrono::steady_clock::now();
+    accumulateRows(source, large, numThreads);
+    VectorXd coefficients;
+    if (!large.solve(coefficients)) {
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double maxError = (coefficients - VectorXd::LinSpaced(numFeatures, 1, numFeatures)).lpNorm<Infinity>();
+    std::cout << large.numRows() << " streamed rows, " << numFeatures << " features: max coefficient error "
+              << maxError << ", MSE " << large.meanSquaredError(coefficients) << ", " << seconds << " s"
+              << std::endl;
+
     return 0;
 } 
\ No newline at end of file
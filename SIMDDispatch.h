@@ -0,0 +1,33 @@
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+/*
+Runtime selection of the widest SIMD instruction set the CPU
+supports, shared by the filter programs. Kernels for AVX2 and
+AVX-512 are compiled with per-function target attributes, so one
+binary runs everywhere and picks its kernel when it starts.
+SIMD_HAVE_X86_DISPATCH is defined where such kernels can be built.
+*/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIMD_HAVE_X86_DISPATCH 1
+#endif
+
+// Instruction sets the SIMD kernels can dispatch to at runtime
+enum class SIMDLevel { Scalar, AVX2, AVX512 };
+
+// Function to detect the widest instruction set supported by the running CPU
+inline SIMDLevel detectSIMDLevel() {
+#ifdef SIMD_HAVE_X86_DISPATCH
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMDLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SIMDLevel::AVX2;
+    }
+#endif
+    return SIMDLevel::Scalar;
+}
+
+#endif
@@ -0,0 +1,557 @@
+#ifndef SIGNAL_IO_H
+#define SIGNAL_IO_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SIGNAL_IO_HAVE_MMAP 1
+#endif
+
+/*
+Shared reader and writer for the text signal files used by
+the filter programs (./data/signals.csv, ./data/signals.txt).
+
+Files are memory-mapped and parsed in place with std::from_chars,
+so no line or cell is ever copied into a std::string. Cells may
+be separated by commas, spaces or tabs, and each line is one row
+(one time step). A cell that is not a number is reported with
+its line and column instead of throwing; it is stored as NaN so
+that the remaining cells keep their row and column positions.
+
+Output is formatted with std::to_chars (shortest representation
+that reads back to the same double) into a large buffer that is
+written in blocks, instead of flushing on every sample.
+
+Captures that are filtered repeatedly can be converted once to
+a binary container: a 64-byte header (magic "NCSIGNAL", format
+version, byte-order mark, sample type, channel count, samples per
+channel and sample rate) followed by the interleaved samples in
+native byte order. Binary files are memory-mapped and read in
+place, so re-runs skip parsing entirely.
+*/
+
+// A multi-channel signal stored interleaved: samples[i * numChannels + c] is
+// sample i of channel c. Keeping the channels of one time step adjacent lets
+// the tap loop run across channels in SIMD lanes.
+struct MultiChannelSignal {
+    int numChannels = 0;
+    std::vector<double> samples;
+
+    std::size_t numSamples() const {
+        return numChannels > 0 ? samples.size() / static_cast<std::size_t>(numChannels) : 0;
+    }
+};
+
+// Location and text of a cell that could not be parsed as a number
+struct SignalParseError {
+    std::size_t line = 0;
+    std::size_t column = 0;
+    std::string cell;
+};
+
+// Read-only view of a whole file, memory-mapped where the platform allows it
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) {
+#ifdef SIGNAL_IO_HAVE_MMAP
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) == 0) {
+            size_ = static_cast<std::size_t>(info.st_size);
+            if (size_ == 0) {
+                isOpen_ = true;
+            } else {
+                void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping != MAP_FAILED) {
+                    ::madvise(mapping, size_, MADV_SEQUENTIAL);
+                    data_ = static_cast<const char*>(mapping);
+                    isOpen_ = true;
+                }
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return;
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        isOpen_ = true;
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef SIGNAL_IO_HAVE_MMAP
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return isOpen_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool isOpen_ = false;
+#ifndef SIGNAL_IO_HAVE_MMAP
+    std::string buffer_;
+#endif
+};
+
+// Function to parse signal text in place. onCell(value) is called for every
+// cell and onRowEnd(numCells, lineNumber) after every non-empty line.
+template <typename CellHandler, typename RowHandler>
+void parseSignalText(const char* text, std::size_t size, CellHandler onCell, RowHandler onRowEnd,
+                     std::vector<SignalParseError>& errors) {
+    const char* p = text;
+    const char* end = text + size;
+    std::size_t lineNumber = 0;
+
+    auto isBlank = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+
+    while (p < end) {
+        ++lineNumber;
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        std::size_t numCells = 0;
+        bool expectCell = false;   // Set after a comma, so "1,,2" reports an empty cell
+        while (true) {
+            while (p < lineEnd && isBlank(*p)) {
+                ++p;
+            }
+            if (p == lineEnd) {
+                if (expectCell) {
+                    errors.push_back({lineNumber, numCells + 1, ""});
+                    onCell(std::numeric_limits<double>::quiet_NaN());
+                    ++numCells;
+                }
+                break;
+            }
+
+            const char* cellBegin = p;
+            if (*cellBegin == ',') {
+                errors.push_back({lineNumber, numCells + 1, ""});
+                onCell(std::numeric_limits<double>::quiet_NaN());
+                ++numCells;
+                ++p;
+                expectCell = true;
+                continue;
+            }
+
+            // std::from_chars does not accept a leading '+'
+            const char* numberBegin = (*cellBegin == '+') ? cellBegin + 1 : cellBegin;
+            double value = 0.0;
+            std::from_chars_result result = std::from_chars(numberBegin, lineEnd, value);
+            p = result.ptr;
+            bool valid = result.ec == std::errc() && (p == lineEnd || isBlank(*p) || *p == ',');
+            if (!valid) {
+                while (p < lineEnd && !isBlank(*p) && *p != ',') {
+                    ++p;
+                }
+                errors.push_back({lineNumber, numCells + 1, std::string(cellBegin, p)});
+                value = std::numeric_limits<double>::quiet_NaN();
+            }
+            onCell(value);
+            ++numCells;
+
+            while (p < lineEnd && isBlank(*p)) {
+                ++p;
+            }
+            expectCell = (p < lineEnd && *p == ',');
+            if (expectCell) {
+                ++p;
+            }
+        }
+
+        if (numCells > 0) {
+            onRowEnd(numCells, lineNumber);
+        }
+        p = (lineEnd == end) ? end : lineEnd + 1;
+    }
+}
+
+// Function to estimate the number of cells from the comma and line separators,
+// so the output can be sized before parsing (blank-separated rows may exceed it)
+inline std::size_t estimateSignalCellCount(const char* text, std::size_t size) {
+    std::size_t separators = 1;
+    for (std::size_t i = 0; i < size; ++i) {
+        separators += (text[i] == '\n') | (text[i] == ',');
+    }
+    return separators;
+}
+
+// Function to print parse errors in the style of the filter programs
+inline void reportSignalParseErrors(const std::string& filename, const std::vector<SignalParseError>& errors) {
+    for (const auto& error : errors) {
+        std::cerr << filename << ":" << error.line << ": malformed cell " << error.column << " \""
+                  << error.cell << "\"" << std::endl;
+    }
+}
+
+// Function to read every cell of a signal file into one flat stream
+inline bool readSignalFile(const std::string& filename, std::vector<double>& data,
+                           std::vector<SignalParseError>& errors) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Failed to open the file: " << filename << std::endl;
+        return false;
+    }
+
+    data.clear();
+    data.reserve(estimateSignalCellCount(file.data(), file.size()));
+    parseSignalText(file.data(), file.size(),
+                    [&](double value) { data.push_back(value); },
+                    [](std::size_t, std::size_t) {},
+                    errors);
+    return true;
+}
+
+// Function to read a file with one row per time step and one column per channel
+inline bool readSignalColumns(const std::string& filename, MultiChannelSignal& signal,
+                              std::vector<SignalParseError>& errors) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Failed to open the file: " << filename << std::endl;
+        return false;
+    }
+
+    signal.numChannels = 0;
+    signal.samples.clear();
+    signal.samples.reserve(estimateSignalCellCount(file.data(), file.size()));
+    bool consistent = true;
+    parseSignalText(file.data(), file.size(),
+                    [&](double value) { signal.samples.push_back(value); },
+                    [&](std::size_t numCells, std::size_t lineNumber) {
+                        if (signal.numChannels == 0) {
+                            signal.numChannels = static_cast<int>(numCells);
+                        } else if (consistent && static_cast<int>(numCells) != signal.numChannels) {
+                            std::cerr << "Inconsistent column count on line " << lineNumber << " of " << filename
+                                      << std::endl;
+                            consistent = false;
+                        }
+                    },
+                    errors);
+
+    if (!consistent) {
+        signal = MultiChannelSignal();
+        return false;
+    }
+    return true;
+}
+
+// Function to stream the cells of a signal file to onBlock(values, count) in
+// blocks of blockSize, so memory stays constant however large the file is
+template <typename BlockHandler>
+bool forEachSignalBlock(const std::string& filename, std::size_t blockSize, BlockHandler onBlock,
+                        std::vector<SignalParseError>& errors) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        std::cerr << "Failed to open the file: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<double> block;
+    block.reserve(blockSize);
+    parseSignalText(file.data(), file.size(),
+                    [&](double value) {
+                        block.push_back(value);
+                        if (block.size() == blockSize) {
+                            onBlock(block.data(), block.size());
+                            block.clear();
+                        }
+                    },
+                    [](std::size_t, std::size_t) {},
+                    errors);
+    if (!block.empty()) {
+        onBlock(block.data(), block.size());
+    }
+    return true;
+}
+
+// Buffered text writer that formats values with std::to_chars and writes the
+// buffer to disk in large blocks
+class SignalWriter {
+public:
+    explicit SignalWriter(const std::string& filename, std::size_t bufferSize = 1 << 20)
+        : file_(filename, std::ios::binary), buffer_(bufferSize < 64 ? 64 : bufferSize) {
+        if (!file_.is_open()) {
+            std::cerr << "Failed to open the file: " << filename << std::endl;
+        }
+    }
+
+    ~SignalWriter() { flush(); }
+
+    SignalWriter(const SignalWriter&) = delete;
+    SignalWriter& operator=(const SignalWriter&) = delete;
+
+    bool isOpen() const { return file_.is_open(); }
+
+    // Function to append a value followed by a separator (',' or '\n')
+    void writeValue(double value, char terminator = '\n') {
+        // Any double takes at most 24 characters in shortest form
+        if (buffer_.size() - used_ < 32) {
+            flush();
+        }
+        char* begin = buffer_.data() + used_;
+        std::to_chars_result result = std::to_chars(begin, buffer_.data() + buffer_.size() - 1, value);
+        *result.ptr = terminator;
+        used_ = (result.ptr + 1) - buffer_.data();
+    }
+
+    // Function to write count values, one per line
+    void writeColumn(const double* values, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            writeValue(values[i]);
+        }
+    }
+
+    // Function to write interleaved rows, numColumns comma-separated values per line
+    void writeRows(const double* values, std::size_t numRows, int numColumns) {
+        for (std::size_t i = 0; i < numRows; ++i) {
+            for (int c = 0; c < numColumns; ++c) {
+                writeValue(values[i * numColumns + c], c + 1 < numColumns ? ',' : '\n');
+            }
+        }
+    }
+
+    // Function to write out the buffered text
+    bool flush() {
+        if (used_ > 0 && file_.is_open()) {
+            file_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+        }
+        used_ = 0;
+        return static_cast<bool>(file_);
+    }
+
+private:
+    std::ofstream file_;
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+};
+
+// Function to write a signal to a text file, one value per line
+inline bool writeSignalFile(const std::string& filename, const std::vector<double>& data) {
+    SignalWriter writer(filename);
+    if (!writer.isOpen()) {
+        return false;
+    }
+    writer.writeColumn(data.data(), data.size());
+    return writer.flush();
+}
+
+// Function to write a multi-channel signal, one row per time step
+inline bool writeSignalColumns(const std::string& filename, const MultiChannelSignal& signal) {
+    SignalWriter writer(filename);
+    if (!writer.isOpen()) {
+        return false;
+    }
+    writer.writeRows(signal.samples.data(), signal.numSamples(), signal.numChannels);
+    return writer.flush();
+}
+
+// Sample types of the binary signal container
+enum class SignalDType : std::uint32_t { Float64 = 1, Float32 = 2 };
+
+// Fixed 64-byte header of the binary signal container
+struct BinarySignalHeader {
+    char magic[8] = {'N', 'C', 'S', 'I', 'G', 'N', 'A', 'L'};
+    std::uint32_t version = 1;
+    std::uint32_t byteOrderMark = 0x01020304;   // Reads differently on a foreign-endian machine
+    std::uint32_t dtype = static_cast<std::uint32_t>(SignalDType::Float64);
+    std::uint32_t numChannels = 1;
+    std::uint64_t numSamples = 0;               // Samples per channel
+    double samplingRate = 0.0;
+    char reserved[24] = {};
+};
+
+static_assert(sizeof(BinarySignalHeader) == 64, "binary signal header must stay 64 bytes");
+
+// Function to return the size in bytes of one sample of the given type
+inline std::size_t signalDTypeSize(std::uint32_t dtype) {
+    return dtype == static_cast<std::uint32_t>(SignalDType::Float32) ? sizeof(float) : sizeof(double);
+}
+
+// Function to check whether a file starts with the binary signal magic
+inline bool isBinarySignalFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[8] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, BinarySignalHeader().magic, sizeof(magic)) == 0;
+}
+
+// Memory-mapped view of a binary signal file. Float64 samples are used in place
+// through samples(); copySamples() converts any sample type to double.
+class BinarySignalFile {
+public:
+    explicit BinarySignalFile(const std::string& filename) : file_(filename) {
+        if (!file_.isOpen()) {
+            std::cerr << "Failed to open the file: " << filename << std::endl;
+            return;
+        }
+        if (file_.size() < sizeof(BinarySignalHeader)) {
+            std::cerr << "Not a binary signal file: " << filename << std::endl;
+            return;
+        }
+
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        BinarySignalHeader expected;
+        bool knownType = header_.dtype == static_cast<std::uint32_t>(SignalDType::Float64) ||
+                         header_.dtype == static_cast<std::uint32_t>(SignalDType::Float32);
+        if (std::memcmp(header_.magic, expected.magic, sizeof(expected.magic)) != 0 ||
+            header_.version != expected.version || header_.byteOrderMark != expected.byteOrderMark ||
+            !knownType || header_.numChannels == 0) {
+            std::cerr << "Unsupported binary signal header in: " << filename << std::endl;
+            return;
+        }
+
+        std::size_t payload = file_.size() - sizeof(BinarySignalHeader);
+        if (payload / signalDTypeSize(header_.dtype) / header_.numChannels < header_.numSamples) {
+            std::cerr << "Truncated binary signal file: " << filename << std::endl;
+            return;
+        }
+        valid_ = true;
+    }
+
+    bool isOpen() const { return valid_; }
+    const BinarySignalHeader& header() const { return header_; }
+    std::size_t numValues() const { return static_cast<std::size_t>(header_.numSamples) * header_.numChannels; }
+
+    // Function to access float64 samples in place; nullptr for other sample types
+    const double* samples() const {
+        if (!valid_ || header_.dtype != static_cast<std::uint32_t>(SignalDType::Float64)) {
+            return nullptr;
+        }
+        return reinterpret_cast<const double*>(file_.data() + sizeof(BinarySignalHeader));
+    }
+
+    // Function to copy count interleaved values starting at value index first
+    void copySamples(std::size_t first, std::size_t count, double* out) const {
+        const char* payload = file_.data() + sizeof(BinarySignalHeader);
+        if (header_.dtype == static_cast<std::uint32_t>(SignalDType::Float32)) {
+            for (std::size_t i = 0; i < count; ++i) {
+                float value;
+                std::memcpy(&value, payload + (first + i) * sizeof(float), sizeof(float));
+                out[i] = value;
+            }
+        } else {
+            std::memcpy(out, payload + first * sizeof(double), count * sizeof(double));
+        }
+    }
+
+private:
+    MappedFile file_;
+    BinarySignalHeader header_;
+    bool valid_ = false;
+};
+
+// Writer for the binary signal container. Samples are appended in blocks and
+// the sample count in the header is filled in when the writer is closed.
+class BinarySignalWriter {
+public:
+    BinarySignalWriter(const std::string& filename, int numChannels, double samplingRate,
+                       SignalDType dtype = SignalDType::Float64)
+        : file_(filename, std::ios::binary) {
+        if (!file_.is_open()) {
+            std::cerr << "Failed to open the file: " << filename << std::endl;
+            return;
+        }
+        header_.numChannels = static_cast<std::uint32_t>(numChannels);
+        header_.samplingRate = samplingRate;
+        header_.dtype = static_cast<std::uint32_t>(dtype);
+        file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    }
+
+    ~BinarySignalWriter() { close(); }
+
+    BinarySignalWriter(const BinarySignalWriter&) = delete;
+    BinarySignalWriter& operator=(const BinarySignalWriter&) = delete;
+
+    bool isOpen() const { return file_.is_open(); }
+
+    // Function to append count interleaved values (a multiple of numChannels)
+    void write(const double* values, std::size_t count) {
+        if (header_.dtype == static_cast<std::uint32_t>(SignalDType::Float32)) {
+            std::vector<float> converted(values, values + count);
+            file_.write(reinterpret_cast<const char*>(converted.data()),
+                        static_cast<std::streamsize>(count * sizeof(float)));
+        } else {
+            file_.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(double)));
+        }
+        valuesWritten_ += count;
+    }
+
+    // Function to record the final length in the header and close the file
+    bool close() {
+        if (!file_.is_open()) {
+            return false;
+        }
+        header_.numSamples = valuesWritten_ / header_.numChannels;
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+        file_.close();
+        return !file_.fail();
+    }
+
+private:
+    std::ofstream file_;
+    BinarySignalHeader header_;
+    std::uint64_t valuesWritten_ = 0;
+};
+
+// Function to write a whole signal as a binary signal file
+inline bool writeBinarySignalFile(const std::string& filename, const double* samples, std::size_t numSamples,
+                                  int numChannels, double samplingRate, SignalDType dtype = SignalDType::Float64) {
+    BinarySignalWriter writer(filename, numChannels, samplingRate, dtype);
+    if (!writer.isOpen()) {
+        return false;
+    }
+    writer.write(samples, numSamples * numChannels);
+    return writer.close();
+}
+
+// Function to convert a text signal (one row per time step, one column per
+// channel) into a binary signal file
+inline bool convertTextSignalToBinary(const std::string& textFilename, const std::string& binaryFilename,
+                                      double samplingRate, SignalDType dtype = SignalDType::Float64) {
+    MultiChannelSignal signal;
+    std::vector<SignalParseError> errors;
+    if (!readSignalColumns(textFilename, signal, errors)) {
+        return false;
+    }
+    if (!errors.empty()) {
+        reportSignalParseErrors(textFilename, errors);
+        return false;
+    }
+    if (signal.numChannels == 0) {
+        std::cerr << "No samples found in: " << textFilename << std::endl;
+        return false;
+    }
+    return writeBinarySignalFile(binaryFilename, signal.samples.data(), signal.numSamples(), signal.numChannels,
+                                 samplingRate, dtype);
+}
+
+#endif
@@ -0,0 +1,307 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "SignalIO.h"
+#include "StreamingFilters.h"
+
+/*
+A fused signal-processing pipeline that chains the FIR filter,
+the biquad IIR filter and a decimator in a single pass over the
+signal, while a separate writer thread saves the result.
+
+Instead of running FIRFilter and IIRFilterAlgorithm one after
+the other, each with its own full-size input, output and file,
+the signal is cut into cache-sized blocks (4096 samples, 32 KB,
+by default). Every block flows through all stages while it is
+still in L1/L2 cache, since each stage filters the block in place
+and keeps its own state between blocks.
+
+Three threads share the work: a reader parses or maps the input
+file, the compute thread runs the stages, and a writer formats
+the output. They are connected by bounded queues and the blocks
+are recycled through a fixed pool, so memory stays constant
+however long the signal is.
+*/
+
+// A processing step applied in place to consecutive blocks of one signal
+class PipelineStage {
+public:
+    virtual ~PipelineStage() = default;
+
+    // Function to process a block in place; stages may shrink the block
+    virtual void process(std::vector<double>& block) = 0;
+
+    // Ratio of output to input sample rate
+    virtual double rateFactor() const { return 1.0; }
+};
+
+// FIR filter stage
+class FIRStage : public PipelineStage {
+public:
+    explicit FIRStage(const std::vector<double>& coefficients) : filter_(coefficients) {}
+
+    void process(std::vector<double>& block) override {
+        filter_.process(block.data(), block.size(), block.data());
+    }
+
+private:
+    StreamingFIRFilter filter_;
+};
+
+// Biquad cascade (IIR) stage
+class IIRStage : public PipelineStage {
+public:
+    explicit IIRStage(const std::vector<BiquadCoefficients>& sections) : cascade_(sections) {}
+
+    void process(std::vector<double>& block) override {
+        cascade_.process(block.data(), block.data(), block.size());
+    }
+
+private:
+    BiquadCascade cascade_;
+};
+
+// Anti-aliasing FIR filter and downsampler, computing only the kept outputs
+class DecimatorStage : public PipelineStage {
+public:
+    DecimatorStage(const std::vector<double>& coefficients, int decimationFactor)
+        : decimator_(coefficients, decimationFactor) {}
+
+    void process(std::vector<double>& block) override {
+        block.resize(decimator_.process(block.data(), block.size(), block.data()));
+    }
+
+    double rateFactor() const override { return 1.0 / decimator_.decimationFactor(); }
+
+private:
+    StreamingFIRDecimator decimator_;
+};
+
+// Fixed-capacity queue that blocks producers when full and consumers when
+// empty. After close(), pop() drains what is left and then returns false.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [&] { return items_.size() < capacity_; });
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [&] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+private:
+    std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+};
+
+// Chain of stages run block by block over a signal
+class SignalPipeline {
+public:
+    // Function to append a stage constructed from the given arguments
+    template <typename Stage, typename... Args>
+    SignalPipeline& add(Args&&... args) {
+        stages_.push_back(std::make_unique<Stage>(std::forward<Args>(args)...));
+        return *this;
+    }
+
+    // Function to run one block through every stage in the calling thread
+    void processBlock(std::vector<double>& block) {
+        for (auto& stage : stages_) {
+            stage->process(block);
+        }
+    }
+
+    // Ratio of the pipeline's output to input sample rate
+    double rateFactor() const {
+        double factor = 1.0;
+        for (const auto& stage : stages_) {
+            factor *= stage->rateFactor();
+        }
+        return factor;
+    }
+
+    // Function to stream a single-channel text or binary signal file through the
+    // pipeline; the output is written in the same format as the input. The
+    // stages must have been designed for samplingRate, so binary input whose
+    // header records a different rate is rejected (see inputSamplingRate).
+    bool run(const std::string& inputFilename, const std::string& outputFilename, double samplingRate,
+             std::size_t blockSize = 4096, std::size_t queueDepth = 4) {
+        bool binary = isBinarySignalFile(inputFilename);
+        std::unique_ptr<BinarySignalFile> binaryInput;
+        if (binary) {
+            binaryInput = std::make_unique<BinarySignalFile>(inputFilename);
+            if (!binaryInput->isOpen()) {
+                return false;
+            }
+            if (binaryInput->header().numChannels != 1) {
+                std::cerr << "The pipeline processes single-channel signals only: " << inputFilename << std::endl;
+                return false;
+            }
+            double fileRate = binaryInput->header().samplingRate;
+            if (fileRate > 0.0 && fileRate != samplingRate) {
+                std::cerr << "The pipeline was designed for " << samplingRate << " Hz but " << inputFilename
+                          << " is sampled at " << fileRate << " Hz." << std::endl;
+                return false;
+            }
+        }
+
+        // Blocks circulate reader -> compute -> writer -> reader, so at most
+        // 2 * queueDepth + 3 blocks ever exist
+        std::size_t poolSize = 2 * queueDepth + 3;
+        BoundedQueue<std::vector<double>> freeBlocks(poolSize);
+        BoundedQueue<std::vector<double>> inputBlocks(queueDepth);
+        BoundedQueue<std::vector<double>> outputBlocks(queueDepth);
+        for (std::size_t k = 0; k < poolSize; ++k) {
+            std::vector<double> block;
+            block.reserve(blockSize);
+            freeBlocks.push(std::move(block));
+        }
+
+        bool readOk = true;
+        bool writeOk = true;
+
+        std::thread reader([&] {
+            std::vector<double> block;
+            if (binary) {
+                std::size_t numSamples = binaryInput->header().numSamples;
+                for (std::size_t first = 0; first < numSamples; first += blockSize) {
+                    freeBlocks.pop(block);
+                    block.resize(std::min(blockSize, numSamples - first));
+                    binaryInput->copySamples(first, block.size(), block.data());
+                    inputBlocks.push(std::move(block));
+                }
+            } else {
+                std::vector<SignalParseError> errors;
+                readOk = forEachSignalBlock(inputFilename, blockSize, [&](const double* values, std::size_t count) {
+                    freeBlocks.pop(block);
+                    block.assign(values, values + count);
+                    inputBlocks.push(std::move(block));
+                }, errors);
+                if (!errors.empty()) {
+                    reportSignalParseErrors(inputFilename, errors);
+                    readOk = false;
+                }
+            }
+            inputBlocks.close();
+        });
+
+        std::thread writer([&] {
+            std::vector<double> block;
+            if (binary) {
+                BinarySignalWriter output(outputFilename, 1, samplingRate * rateFactor());
+                writeOk = output.isOpen();
+                while (outputBlocks.pop(block)) {
+                    output.write(block.data(), block.size());
+                    freeBlocks.push(std::move(block));
+                }
+                writeOk = writeOk && output.close();
+            } else {
+                SignalWriter output(outputFilename);
+                writeOk = output.isOpen();
+                while (outputBlocks.pop(block)) {
+                    output.writeColumn(block.data(), block.size());
+                    freeBlocks.push(std::move(block));
+                }
+                writeOk = writeOk && output.flush();
+            }
+        });
+
+        // Compute stage: every block passes through all stages while it is hot in cache
+        std::vector<double> block;
+        while (inputBlocks.pop(block)) {
+            processBlock(block);
+            outputBlocks.push(std::move(block));
+        }
+        outputBlocks.close();
+
+        reader.join();
+        writer.join();
+        return readOk && writeOk;
+    }
+
+private:
+    std::vector<std::unique_ptr<PipelineStage>> stages_;
+};
+
+// Function to return the sampling rate recorded in a binary signal file, or
+// defaultRate for text files, which carry no rate
+double inputSamplingRate(const std::string& filename, double defaultRate) {
+    if (!isBinarySignalFile(filename)) {
+        return defaultRate;
+    }
+    BinarySignalFile file(filename);
+    if (file.isOpen() && file.header().samplingRate > 0.0) {
+        return file.header().samplingRate;
+    }
+    return defaultRate;
+}
+
+int main(int argc, char* argv[]) {
+    std::string inputFilename = "./data/signals.csv";
+    std::string outputFilename = "./data/pipeline_output.csv";
+    double samplingRate = 1000.0;   // Default sampling rate in Hz, for text input
+    double cutoffFrequency = 10.0;  // Default cutoff frequency in Hz
+
+    // Input and output files may be given on the command line (text or binary)
+    if (argc >= 3) {
+        inputFilename = argv[1];
+        outputFilename = argv[2];
+    }
+
+    // Binary input records its own rate, and every stage is designed for it
+    samplingRate = inputSamplingRate(inputFilename, samplingRate);
+
+    // Decimate as far as keeps the output rate at least ten times the cutoff,
+    // so its Nyquist frequency stays well above the filtered band
+    int decimationFactor = std::max(1, static_cast<int>(samplingRate / (10.0 * cutoffFrequency)));
+
+    // Moving-average FIR, as in FIRFilter.cpp
+    std::vector<double> firCoefficients = computeFIRLowPassCoefficients(cutoffFrequency, samplingRate);
+
+    // Anti-aliasing filter for the decimator: a boxcar one output period long
+    std::vector<double> decimatorCoefficients(decimationFactor, 1.0 / decimationFactor);
+
+    SignalPipeline pipeline;
+    pipeline.add<FIRStage>(firCoefficients)
+            .add<IIRStage>(designButterworthLowPass(4, cutoffFrequency, samplingRate))
+            .add<DecimatorStage>(decimatorCoefficients, decimationFactor);
+
+    if (!pipeline.run(inputFilename, outputFilename, samplingRate)) {
+        return 1;
+    }
+
+    std::cout << "Pipeline completed. Output written to " << outputFilename << std::endl;
+
+    return 0;
+}
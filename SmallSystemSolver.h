@@ -0,0 +1,165 @@
+#ifndef SMALL_SYSTEM_SOLVER_H
+#define SMALL_SYSTEM_SOLVER_H
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+/*
+Batched solver for many tiny dense systems Ax = b of the same
+compile-time size N (the 3x3 and 4x4 systems that come out of
+quadratic/cubic interpolation and small linear models).
+
+The batch is stored as structure of arrays so that entry (i, j)
+of every system sits next to the same entry of its neighbours:
+
+    A(i, j) of system s  ->  A[(i * N + j) * count + s]
+    b(i)    of system s  ->  b[i * count + s]
+    x(i)    of system s  ->  x[i * count + s]
+
+Systems are processed kSmallSystemLanes at a time. Gaussian
+elimination with partial pivoting is fully unrolled over N and
+every step is written as a loop across the lanes, with pivot
+choice, row swaps and the singular test done by selects instead
+of branches, so the compiler turns each step into SIMD
+instructions (build with -O2 or higher and a -march that has
+AVX2 or AVX-512 to get 4 or 8 lanes per instruction). Nothing is
+allocated on the heap.
+
+A system is flagged singular when a pivot is no larger than
+N * epsilon times the largest entry of its matrix; its solution
+is then meaningless but finite.
+*/
+
+// Number of systems advanced together
+const int kSmallSystemLanes = 8;
+
+// Function to solve count systems of size N stored as structure of arrays.
+// singular[s] is set to 1 if system s is numerically singular, else 0.
+template <int N>
+void solveSmallSystems(const double* A, const double* b, double* x, unsigned char* singular, std::size_t count) {
+    const int L = kSmallSystemLanes;
+    const double tolerance = N * std::numeric_limits<double>::epsilon();
+
+    for (std::size_t first = 0; first < count; first += L) {
+        std::size_t active = (count - first < static_cast<std::size_t>(L)) ? count - first : L;
+
+        // Load a chunk of systems; unused lanes of the last chunk get the identity
+        double a[N][N][L];
+        double r[N][L];
+        double scale[L];
+        unsigned char flag[L];
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                const double* source = A + (i * N + j) * count + first;
+                for (int l = 0; l < L; ++l) {
+                    a[i][j][l] = (i == j) ? 1.0 : 0.0;
+                }
+                for (std::size_t l = 0; l < active; ++l) {
+                    a[i][j][l] = source[l];
+                }
+            }
+            const double* source = b + i * count + first;
+            for (int l = 0; l < L; ++l) {
+                r[i][l] = 0.0;
+            }
+            for (std::size_t l = 0; l < active; ++l) {
+                r[i][l] = source[l];
+            }
+        }
+        for (int l = 0; l < L; ++l) {
+            scale[l] = 0.0;
+            flag[l] = 0;
+        }
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                for (int l = 0; l < L; ++l) {
+                    scale[l] = std::fabs(a[i][j][l]) > scale[l] ? std::fabs(a[i][j][l]) : scale[l];
+                }
+            }
+        }
+
+        for (int k = 0; k < N; ++k) {
+            // Choose the pivot row per lane
+            int pivot[L];
+            double best[L];
+            for (int l = 0; l < L; ++l) {
+                pivot[l] = k;
+                best[l] = std::fabs(a[k][k][l]);
+            }
+            for (int i = k + 1; i < N; ++i) {
+                for (int l = 0; l < L; ++l) {
+                    bool better = std::fabs(a[i][k][l]) > best[l];
+                    best[l] = better ? std::fabs(a[i][k][l]) : best[l];
+                    pivot[l] = better ? i : pivot[l];
+                }
+            }
+
+            // Swap rows k and pivot[l] with selects
+            for (int i = k + 1; i < N; ++i) {
+                for (int j = k; j < N; ++j) {
+                    for (int l = 0; l < L; ++l) {
+                        bool swap = pivot[l] == i;
+                        double top = a[k][j][l];
+                        double row = a[i][j][l];
+                        a[k][j][l] = swap ? row : top;
+                        a[i][j][l] = swap ? top : row;
+                    }
+                }
+                for (int l = 0; l < L; ++l) {
+                    bool swap = pivot[l] == i;
+                    double top = r[k][l];
+                    double row = r[i][l];
+                    r[k][l] = swap ? row : top;
+                    r[i][l] = swap ? top : row;
+                }
+            }
+
+            // Flag negligible pivots and replace them by 1 to keep the arithmetic finite
+            for (int l = 0; l < L; ++l) {
+                bool tiny = best[l] <= tolerance * scale[l];
+                flag[l] |= tiny;
+                a[k][k][l] = tiny ? 1.0 : a[k][k][l];
+            }
+
+            // Eliminate below the pivot
+            for (int i = k + 1; i < N; ++i) {
+                double factor[L];
+                for (int l = 0; l < L; ++l) {
+                    factor[l] = a[i][k][l] / a[k][k][l];
+                }
+                for (int j = k + 1; j < N; ++j) {
+                    for (int l = 0; l < L; ++l) {
+                        a[i][j][l] -= factor[l] * a[k][j][l];
+                    }
+                }
+                for (int l = 0; l < L; ++l) {
+                    r[i][l] -= factor[l] * r[k][l];
+                }
+            }
+        }
+
+        // Back substitution
+        for (int i = N - 1; i >= 0; --i) {
+            for (int j = i + 1; j < N; ++j) {
+                for (int l = 0; l < L; ++l) {
+                    r[i][l] -= a[i][j][l] * r[j][l];
+                }
+            }
+            for (int l = 0; l < L; ++l) {
+                r[i][l] /= a[i][i][l];
+            }
+        }
+
+        for (int i = 0; i < N; ++i) {
+            for (std::size_t l = 0; l < active; ++l) {
+                x[i * count + first + l] = r[i][l];
+            }
+        }
+        for (std::size_t l = 0; l < active; ++l) {
+            singular[first + l] = flag[l];
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef STREAMING_FILTERS_H
+#define STREAMING_FILTERS_H
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <complex>
+#include <algorithm>
+
+/*
+Stateful FIR and IIR filters shared by the filter programs
+(FIRFilter.cpp, IIRFilterAlgorithm.cpp) and the fused signal
+pipeline (SignalPipeline.cpp). Every filter keeps its state
+between calls, so a signal can be processed block by block in
+constant memory with the same result as a single call.
+*/
+
+// Function to compute the low-pass (moving average) filter coefficients
+inline std::vector<double> computeFIRLowPassCoefficients(double cutoffFrequency, double samplingRate) {
+    int filterOrder = static_cast<int>(std::ceil(0.45 * samplingRate / cutoffFrequency));
+    return std::vector<double>(filterOrder + 1, 1.0 / (filterOrder + 1));
+}
+
+// Stateful FIR filter that keeps the last filterOrder samples between calls,
+// so a signal can be filtered chunk by chunk in constant memory. The output
+// matches a direct-form convolution (applyFIRFilter in FIRMode::Direct) of
+// the concatenated input bit for bit; since applyFIRFilter switches to FFT
+// convolution at kFFTTapThreshold taps, FIRFilter.cpp wraps it in
+// StreamingBlockFIRFilter to match the automatic choice instead.
+class StreamingFIRFilter {
+public:
+    explicit StreamingFIRFilter(const std::vector<double>& coefficients) : coefficients_(coefficients) {
+        if (coefficients_.empty()) {
+            // The ring buffer needs at least one tap; a single zero tap outputs zeros
+            std::cerr << "A streaming FIR filter needs at least one coefficient." << std::endl;
+            coefficients_.assign(1, 0.0);
+            ok_ = false;
+        }
+        numTaps_ = static_cast<int>(coefficients_.size());
+        history_.assign(2 * coefficients_.size(), 0.0);
+    }
+
+    bool ok() const { return ok_; }
+
+    // Function to filter count samples from input into output (may alias)
+    void process(const double* input, std::size_t count, double* output) {
+        int filterOrder = numTaps_ - 1;
+        for (std::size_t n = 0; n < count; ++n) {
+            // Each sample is stored twice so the newest numTaps_ samples are
+            // always contiguous, ending at history_[position_ + numTaps_]
+            position_ = (position_ + 1) % numTaps_;
+            history_[position_] = input[n];
+            history_[position_ + numTaps_] = input[n];
+
+            const double* newest = &history_[position_ + numTaps_];
+            int lastTap = static_cast<int>(std::min<long long>(samplesSeen_, filterOrder));
+            double sum = 0.0;
+            for (int j = 0; j <= lastTap; ++j) {
+                sum += coefficients_[j] * newest[-j];
+            }
+            output[n] = sum;
+            ++samplesSeen_;
+        }
+    }
+
+    // Function to filter one chunk and return the filtered chunk
+    std::vector<double> process(const std::vector<double>& chunk) {
+        std::vector<double> filteredChunk(chunk.size());
+        process(chunk.data(), chunk.size(), filteredChunk.data());
+        return filteredChunk;
+    }
+
+    // Function to clear the tap state before starting a new signal
+    void reset() {
+        std::fill(history_.begin(), history_.end(), 0.0);
+        position_ = 0;
+        samplesSeen_ = 0;
+    }
+
+private:
+    std::vector<double> coefficients_;
+    int numTaps_;
+    std::vector<double> history_;
+    int position_ = 0;
+    long long samplesSeen_ = 0;
+    bool ok_ = true;
+};
+
+// Stateful FIR decimator: filters and keeps every decimationFactor-th output
+// (output indices 0, M, 2M, ... of the whole stream), computing only the kept
+// outputs. The result matches decimateFIR on the concatenated input bit for bit.
+class StreamingFIRDecimator {
+public:
+    StreamingFIRDecimator(const std::vector<double>& coefficients, int decimationFactor)
+        : coefficients_(coefficients),
+          filterOrder_(static_cast<int>(coefficients.size()) - 1),
+          decimationFactor_(decimationFactor < 1 ? 1 : decimationFactor) {}
+
+    // Function to consume count samples and write the kept outputs to output
+    // (which may alias input); returns the number of outputs written
+    std::size_t process(const double* input, std::size_t count, double* output) {
+        // The buffer holds up to filterOrder_ samples of history followed by the new samples
+        buffer_.resize(historyLength_ + count);
+        std::copy(input, input + count, buffer_.begin() + historyLength_);
+
+        std::size_t written = 0;
+        long long firstKept = (samplesSeen_ + decimationFactor_ - 1) / decimationFactor_ * decimationFactor_;
+        for (long long i = firstKept; i < samplesSeen_ + static_cast<long long>(count); i += decimationFactor_) {
+            const double* newest = &buffer_[historyLength_ + static_cast<std::size_t>(i - samplesSeen_)];
+            int lastTap = static_cast<int>(std::min<long long>(i, filterOrder_));
+            double sum = 0.0;
+            for (int j = 0; j <= lastTap; ++j) {
+                sum += coefficients_[j] * newest[-j];
+            }
+            output[written++] = sum;
+        }
+
+        // Keep the newest filterOrder_ samples as history for the next call
+        std::size_t keep = std::min<std::size_t>(filterOrder_, buffer_.size());
+        std::copy(buffer_.end() - keep, buffer_.end(), buffer_.begin());
+        buffer_.resize(keep);
+        historyLength_ = keep;
+        samplesSeen_ += count;
+        return written;
+    }
+
+    int decimationFactor() const { return decimationFactor_; }
+
+private:
+    std::vector<double> coefficients_;
+    int filterOrder_;
+    int decimationFactor_;
+    std::vector<double> buffer_;
+    std::size_t historyLength_ = 0;
+    long long samplesSeen_ = 0;
+};
+
+// Coefficients of one second-order section, normalized so that a0 = 1:
+// H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+// A first-order section has b2 = a2 = 0.
+struct BiquadCoefficients {
+    double b0 = 1.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+};
+
+// Cascade of second-order sections in transposed direct form II. The two
+// state variables of every section persist between calls, so a signal can be
+// filtered block by block; blocks are written to caller-provided buffers and
+// nothing is allocated after construction.
+class BiquadCascade {
+public:
+    explicit BiquadCascade(const std::vector<BiquadCoefficients>& sections)
+        : sections_(sections), state_(2 * sections.size(), 0.0) {}
+
+    // Function to filter count samples from input into output (may alias)
+    void process(const double* input, double* output, std::size_t count) {
+        const double* source = input;
+        for (std::size_t k = 0; k < sections_.size(); ++k) {
+            const BiquadCoefficients& c = sections_[k];
+            double z1 = state_[2 * k];
+            double z2 = state_[2 * k + 1];
+            for (std::size_t i = 0; i < count; ++i) {
+                double x = source[i];
+                double y = c.b0 * x + z1;
+                z1 = c.b1 * x - c.a1 * y + z2;
+                z2 = c.b2 * x - c.a2 * y;
+                output[i] = y;
+            }
+            state_[2 * k] = z1;
+            state_[2 * k + 1] = z2;
+            source = output;
+        }
+        if (sections_.empty() && output != input) {
+            std::copy(input, input + count, output);
+        }
+    }
+
+    // Function to filter a single sample
+    double processSample(double x) {
+        for (std::size_t k = 0; k < sections_.size(); ++k) {
+            const BiquadCoefficients& c = sections_[k];
+            double y = c.b0 * x + state_[2 * k];
+            state_[2 * k] = c.b1 * x - c.a1 * y + state_[2 * k + 1];
+            state_[2 * k + 1] = c.b2 * x - c.a2 * y;
+            x = y;
+        }
+        return x;
+    }
+
+    // Function to clear the state before starting a new signal
+    void reset() {
+        std::fill(state_.begin(), state_.end(), 0.0);
+    }
+
+    const std::vector<BiquadCoefficients>& sections() const { return sections_; }
+
+    // State as (z1, z2) pairs, one pair per section
+    const std::vector<double>& state() const { return state_; }
+    void setState(const std::vector<double>& state) { state_ = state; }
+
+private:
+    std::vector<BiquadCoefficients> sections_;
+    std::vector<double> state_;
+};
+
+// Function to map analog low-pass poles (with unity DC gain per section) to
+// digital sections using the bilinear transform s = K (1 - z^-1) / (1 + z^-1).
+// Only poles with non-negative imaginary part are passed; each complex pole
+// stands for its conjugate pair.
+inline std::vector<BiquadCoefficients> bilinearLowPassSections(const std::vector<std::complex<double>>& poles,
+                                                               double samplingRate) {
+    double K = 2.0 * samplingRate;
+    std::vector<BiquadCoefficients> sections;
+
+    for (const auto& pole : poles) {
+        BiquadCoefficients section;
+        if (std::abs(pole.imag()) < 1e-12 * std::abs(pole)) {
+            // Real pole: H(s) = w / (s + w)
+            double w = -pole.real();
+            double d0 = K + w;
+            section.b0 = w / d0;
+            section.b1 = w / d0;
+            section.a1 = (w - K) / d0;
+        } else {
+            // Conjugate pair: H(s) = |p|^2 / (s^2 - 2 Re(p) s + |p|^2)
+            double a = -2.0 * pole.real();
+            double b = std::norm(pole);
+            double d0 = K * K + a * K + b;
+            section.b0 = b / d0;
+            section.b1 = 2.0 * b / d0;
+            section.b2 = b / d0;
+            section.a1 = (2.0 * b - 2.0 * K * K) / d0;
+            section.a2 = (K * K - a * K + b) / d0;
+        }
+        sections.push_back(section);
+    }
+
+    return sections;
+}
+
+// Function to design a Butterworth low-pass filter as second-order sections
+inline std::vector<BiquadCoefficients> designButterworthLowPass(int order, double cutoffFrequency, double samplingRate) {
+    if (order < 1 || cutoffFrequency <= 0.0 || cutoffFrequency >= samplingRate / 2.0) {
+        std::cerr << "Invalid Butterworth design: order must be positive and the cutoff inside (0, fs/2)." << std::endl;
+        return std::vector<BiquadCoefficients>();
+    }
+
+    // Prewarp the cutoff so the digital filter is -3 dB exactly at cutoffFrequency
+    double warped = 2.0 * samplingRate * std::tan(M_PI * cutoffFrequency / samplingRate);
+
+    std::vector<std::complex<double>> poles;
+    for (int k = 0; k < order / 2; ++k) {
+        double theta = M_PI * (2.0 * k + 1.0) / (2.0 * order);
+        poles.push_back(warped * std::complex<double>(-std::sin(theta), std::cos(theta)));
+    }
+    if (order % 2 == 1) {
+        poles.push_back(std::complex<double>(-warped, 0.0));
+    }
+
+    return bilinearLowPassSections(poles, samplingRate);
+}
+
+// Function to design a Chebyshev type I low-pass filter with rippleDb of
+// passband ripple as second-order sections
+inline std::vector<BiquadCoefficients> designChebyshevLowPass(int order, double rippleDb, double cutoffFrequency,
+                                                              double samplingRate) {
+    if (order < 1 || rippleDb <= 0.0 || cutoffFrequency <= 0.0 || cutoffFrequency >= samplingRate / 2.0) {
+        std::cerr << "Invalid Chebyshev design: order and ripple must be positive and the cutoff inside (0, fs/2)."
+                  << std::endl;
+        return std::vector<BiquadCoefficients>();
+    }
+
+    double warped = 2.0 * samplingRate * std::tan(M_PI * cutoffFrequency / samplingRate);
+    double epsilon = std::sqrt(std::pow(10.0, rippleDb / 10.0) - 1.0);
+    double v0 = std::asinh(1.0 / epsilon) / order;
+
+    std::vector<std::complex<double>> poles;
+    for (int k = 0; k < order / 2; ++k) {
+        double theta = M_PI * (2.0 * k + 1.0) / (2.0 * order);
+        poles.push_back(warped * std::complex<double>(-std::sinh(v0) * std::sin(theta),
+                                                      std::cosh(v0) * std::cos(theta)));
+    }
+    if (order % 2 == 1) {
+        poles.push_back(std::complex<double>(-warped * std::sinh(v0), 0.0));
+    }
+
+    std::vector<BiquadCoefficients> sections = bilinearLowPassSections(poles, samplingRate);
+
+    // Even orders sit at the bottom of the ripple band at DC
+    if (order % 2 == 0) {
+        double gain = 1.0 / std::sqrt(1.0 + epsilon * epsilon);
+        sections.front().b0 *= gain;
+        sections.front().b1 *= gain;
+        sections.front().b2 *= gain;
+    }
+
+    return sections;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <Eigen/Dense>
+
+#include "TiledCholesky.h"
+
+/*
+Benchmark of the tiled, task-parallel Cholesky factorization in
+TiledCholesky.h against Eigen's single-threaded LLT, used so far by
+CholeskyDecomposition.cpp and MultivariateLinearRegression.cpp.
+
+For an n x n SPD matrix (a normal-equations matrix A^T A + n I) it
+times LLT, then the tiled factorization on 1, 2, 4, ... threads up
+to the number of cores, and checks ||L - L_LLT|| / ||L_LLT||.
+Usage: TiledCholesky [n] [tileSize]
+*/
+
+int main(int argc, char* argv[]) {
+    int n = 3000;
+    int tileSize = 256;
+    if (argc >= 2) {
+        n = std::atoi(argv[1]);
+    }
+    if (argc >= 3) {
+        tileSize = std::atoi(argv[2]);
+    }
+
+    // A normal-equations matrix: well conditioned and SPD
+    Eigen::MatrixXd X = Eigen::MatrixXd::Random(n, n);
+    Eigen::MatrixXd A = X.transpose() * X + n * Eigen::MatrixXd::Identity(n, n);
+
+    auto elapsed = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    Eigen::LLT<Eigen::MatrixXd> llt(A);
+    double lltSeconds = elapsed(start);
+    Eigen::MatrixXd reference = llt.matrixL();
+    std::cout << "n = " << n << ", tile " << tileSize << std::endl;
+    std::cout << "LLT: " << lltSeconds << " s" << std::endl;
+
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int threads = 1; ; threads = std::min(2 * threads, cores)) {
+        Eigen::MatrixXd L;
+        start = std::chrono::steady_clock::now();
+        if (!tiledCholesky(A, L, threads, tileSize)) {
+            return 1;
+        }
+        double seconds = elapsed(start);
+        std::cout << "Tiled, " << threads << " thread(s): " << seconds << " s, speedup over LLT "
+                  << lltSeconds / seconds << ", relative difference " << (L - reference).norm() / reference.norm()
+                  << std::endl;
+        if (threads == cores) {
+            break;
+        }
+    }
+
+    return 0;
+}
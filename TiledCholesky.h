@@ -0,0 +1,236 @@
+#ifndef TILED_CHOLESKY_H
+#define TILED_CHOLESKY_H
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Eigen/Dense>
+
+/*
+Tiled, multithreaded Cholesky factorization A = L L^T for the
+large SPD matrices (normal equations several thousand on a side)
+on which a single-threaded LLT becomes the bottleneck.
+
+The lower triangle is cut into nb x nb tiles. Every tile is stored
+contiguously (column-major within the tile), so a kernel touching
+a tile streams one compact block instead of nb strided columns of
+a large matrix. The factorization becomes a set of tile tasks; for
+each step k:
+
+    POTRF  L_kk = chol(A_kk)
+    TRSM   A_ik = A_ik L_kk^-T                       i > k
+    SYRK   A_ii = A_ii - A_ik A_ik^T                  i > k
+    GEMM   A_ij = A_ij - A_ik A_jk^T                  i > j > k
+
+Rather than running the steps one after another with a barrier
+in between, each task waits only for the tasks producing the tiles
+it reads and for the previous update of the tile it writes. The
+next panel can therefore start while trailing updates of the
+current step are still running. The dependency DAG is run on a
+work-stealing pool: each thread pops ready tasks from the back of
+its own deque (most recently released, still hot in cache) and,
+when empty, steals from the front of another thread's deque.
+*/
+
+// Lower triangle of a symmetric matrix stored as contiguous tiles
+class TiledMatrix {
+public:
+    TiledMatrix(const Eigen::MatrixXd& A, int tileSize) : n_(static_cast<int>(A.rows())), tileSize_(tileSize) {
+        numTiles_ = (n_ + tileSize_ - 1) / tileSize_;
+        offsets_.resize(numTiles_ * (numTiles_ + 1) / 2);
+        std::size_t offset = 0;
+        for (int i = 0; i < numTiles_; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                offsets_[index(i, j)] = offset;
+                offset += static_cast<std::size_t>(tileRows(i)) * tileRows(j);
+            }
+        }
+        data_.resize(offset);
+        for (int i = 0; i < numTiles_; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                tile(i, j) = A.block(i * tileSize_, j * tileSize_, tileRows(i), tileRows(j));
+            }
+        }
+    }
+
+    int size() const { return n_; }
+    int numTiles() const { return numTiles_; }
+    int tileRows(int i) const { return std::min(tileSize_, n_ - i * tileSize_); }
+
+    Eigen::Map<Eigen::MatrixXd> tile(int i, int j) {
+        return Eigen::Map<Eigen::MatrixXd>(data_.data() + offsets_[index(i, j)], tileRows(i), tileRows(j));
+    }
+
+    // Function to copy the lower triangle back into a dense matrix
+    Eigen::MatrixXd toDense() {
+        Eigen::MatrixXd A = Eigen::MatrixXd::Zero(n_, n_);
+        for (int i = 0; i < numTiles_; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                A.block(i * tileSize_, j * tileSize_, tileRows(i), tileRows(j)) = tile(i, j);
+            }
+        }
+        A.triangularView<Eigen::StrictlyUpper>().setZero();
+        return A;
+    }
+
+private:
+    int index(int i, int j) const { return i * (i + 1) / 2 + j; }
+
+    int n_;
+    int tileSize_;
+    int numTiles_;
+    std::vector<std::size_t> offsets_;
+    std::vector<double> data_;
+};
+
+// A node of a task graph: run() may start once all dependencies have finished
+struct GraphTask {
+    std::function<void()> run;
+    std::vector<int> successors;
+    int dependencies = 0;
+};
+
+// Function to run a task DAG on numThreads threads with work stealing
+inline void runTaskGraph(std::vector<GraphTask>& tasks, int numThreads) {
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+    std::vector<WorkQueue> queues(numThreads);
+    std::vector<std::atomic<int>> pending(tasks.size());
+    std::atomic<std::size_t> remaining(tasks.size());
+
+    int next = 0;
+    for (std::size_t t = 0; t < tasks.size(); ++t) {
+        pending[t] = tasks[t].dependencies;
+        if (tasks[t].dependencies == 0) {
+            queues[next++ % numThreads].tasks.push_back(static_cast<int>(t));
+        }
+    }
+
+    auto worker = [&](int self) {
+        while (remaining.load() > 0) {
+            int task = -1;
+            {
+                std::lock_guard<std::mutex> lock(queues[self].mutex);
+                if (!queues[self].tasks.empty()) {
+                    task = queues[self].tasks.back();
+                    queues[self].tasks.pop_back();
+                }
+            }
+            for (int victim = (self + 1) % numThreads; task < 0 && victim != self; victim = (victim + 1) % numThreads) {
+                std::lock_guard<std::mutex> lock(queues[victim].mutex);
+                if (!queues[victim].tasks.empty()) {
+                    task = queues[victim].tasks.front();
+                    queues[victim].tasks.pop_front();
+                }
+            }
+            if (task < 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            tasks[task].run();
+            for (int successor : tasks[task].successors) {
+                if (pending[successor].fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(queues[self].mutex);
+                    queues[self].tasks.push_back(successor);
+                }
+            }
+            remaining.fetch_sub(1);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Function to factor a tiled SPD matrix in place into its Cholesky factor L
+inline bool tiledCholesky(TiledMatrix& A, int numThreads) {
+    const int T = A.numTiles();
+    std::vector<GraphTask> tasks;
+    std::vector<int> lastWriter(T * (T + 1) / 2, -1);  // Last task writing each tile
+    std::atomic<bool> failed(false);
+
+    // Function to add a task writing tile (i, j) after reading the given tiles
+    auto addTask = [&](int i, int j, std::initializer_list<std::pair<int, int>> reads, std::function<void()> run) {
+        int id = static_cast<int>(tasks.size());
+        tasks.push_back(GraphTask());
+        tasks[id].run = [run, &failed] {
+            if (!failed.load()) {
+                run();
+            }
+        };
+        std::vector<int> dependencies;
+        for (auto tile : reads) {
+            dependencies.push_back(lastWriter[tile.first * (tile.first + 1) / 2 + tile.second]);
+        }
+        int& writer = lastWriter[i * (i + 1) / 2 + j];
+        dependencies.push_back(writer);
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+        for (int dependency : dependencies) {
+            if (dependency >= 0) {
+                tasks[dependency].successors.push_back(id);
+                ++tasks[id].dependencies;
+            }
+        }
+        writer = id;
+    };
+
+    for (int k = 0; k < T; ++k) {
+        addTask(k, k, {}, [&A, &failed, k] {
+            Eigen::Map<Eigen::MatrixXd> Akk = A.tile(k, k);
+            Eigen::LLT<Eigen::Ref<Eigen::MatrixXd>> llt(Akk);  // In place
+            if (llt.info() != Eigen::Success) {
+                failed = true;
+            }
+        });
+        for (int i = k + 1; i < T; ++i) {
+            addTask(i, k, {{k, k}}, [&A, i, k] {
+                Eigen::Map<Eigen::MatrixXd> Aik = A.tile(i, k);
+                A.tile(k, k).triangularView<Eigen::Lower>().transpose().solveInPlace<Eigen::OnTheRight>(Aik);
+            });
+        }
+        for (int i = k + 1; i < T; ++i) {
+            addTask(i, i, {{i, k}}, [&A, i, k] {
+                A.tile(i, i).selfadjointView<Eigen::Lower>().rankUpdate(A.tile(i, k), -1.0);
+            });
+            for (int j = k + 1; j < i; ++j) {
+                addTask(i, j, {{i, k}, {j, k}}, [&A, i, j, k] {
+                    A.tile(i, j).noalias() -= A.tile(i, k) * A.tile(j, k).transpose();
+                });
+            }
+        }
+    }
+
+    runTaskGraph(tasks, std::max(1, numThreads));
+    if (failed) {
+        std::cerr << "Tiled Cholesky failed: the matrix is not positive definite." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to compute the Cholesky factor L of a dense SPD matrix with tiles
+inline bool tiledCholesky(const Eigen::MatrixXd& A, Eigen::MatrixXd& L, int numThreads, int tileSize = 256) {
+    TiledMatrix tiles(A, tileSize);
+    if (!tiledCholesky(tiles, numThreads)) {
+        return false;
+    }
+    L = tiles.toDense();
+    return true;
+}
+
+#endif